@@ -18,7 +18,7 @@
     // The code introduces three namespaces: SPHINXHash, SPHINXMerkleBlock, and SPHINXBlock.
     // Namespaces are used to group related functionality, and they help prevent naming conflicts.
     // The SPHINXHash namespace contains the SPHINX_256 function, which is used to calculate the hash of data using the SPHINX_256 algorithm.
-    // The SPHINXMerkleBlock namespace provides the constructMerkleTree function, which is used to construct the Merkle tree for the block.
+    // The SPHINXMerkleBlock namespace provides the SPHINCS+ key types; the block's Merkle tree is kept by MerkleAccumulator.
 
 // Private Member Variables:
     // The Block class has several private member variables that store information about a block in the blockchain.
@@ -29,7 +29,9 @@
     // timestamp_: The time when the block was created.
     // nonce_: A random value used in the mining process to find a valid block hash.
     // difficulty_: A measure of how hard it is to find a valid block hash (mining difficulty).
-    // transactions_: The list of transactions included in the block.
+    // transactions_: The list of transactions included in the block, kept in a TransactionArena (one byte buffer plus an offsets table).
+    // merkleTree_: The incremental Merkle tree (MerkleAccumulator) over transactions_, with every level cached.
+    // blockHash_: The memoized block hash (HashMemo), dropped by every function that changes a header field.
     // blockchain_: A pointer to the blockchain (assuming SPHINXChain::Chain is a class).
     // checkpointBlocks_: A reference to the list of checkpoint blocks.
     // storedMerkleRoot_: A private member variable to store the Merkle root for signature verification purposes.
@@ -41,22 +43,37 @@
     // The second constructor additionally takes a vector of checkpoint blocks as input.
 
 // Member Functions:
-    // addTransaction: Adds a transaction to the block by appending it to the transactions_ vector.
-    // calculateBlockHash: Calculates the block hash by concatenating relevant data and computing the SPHINX_256 hash of the block data.
-    // calculateMerkleRoot: Calculates the Merkle root of the transactions in the block using the constructMerkleTree function from the SPHINXMerkleBlock namespace.
+    // addTransaction: Adds a transaction to the block by appending it to the transactions_ arena and updating the Merkle tree in O(log n).
+    // replaceTransaction: Overwrites one transaction in place and rehashes only its Merkle path (used by BlockTemplateBuilder).
+    // getTransactionArena / getTransaction / getTransactionCount: Non-copying access to the transactions as string_views.
+    // serializeHeader: Builds the fixed-size binary header (previous hash, Merkle root, height, timestamp, difficulty, nonce).
+    // getHeader: Extracts the compact, trivially copyable BlockHeader (the hashed fields only) for light clients and header indexes.
+    // calculateBlockHash: Calculates the block hash from the binary header with the midstate HeaderHasher, so the cost does not grow with the number of transactions.
+    // getBlockHash: Returns the memoized block hash, calculating it only after the header has changed. Safe for concurrent const readers.
+    // calculateMerkleRoot: Returns the Merkle root of the transactions, cached by the incremental merkleTree_. Full rebuilds (setTransactions, fromJson, fromBinary) hash large levels in parallel on the shared Merkle pool.
+    // getMerkleProof: Builds the Merkle inclusion proof for a single transaction.
     // signMerkleRoot: Signs the Merkle root with SPHINCS+ private key and stores the signature and Merkle root for later verification.
     // verifySignature: Verifies the block's signature using the SPHINCS+ verification function available in the library.
-    // verifyMerkleRoot: Verifies the block's Merkle root using the verifyMerkleRoot function from the SPHINXMerkleBlock namespace.
+    // verifyMerkleRoot: Verifies that the signed (or header) Merkle root matches the root of the block's transactions.
     // verifyBlock: Verifies the entire block (signature and Merkle root) with the given public key.
-    // mineBlock: Attempts to mine the block by finding a valid hash that meets the mining difficulty level.
+    // mineBlock: Attempts to mine the block by finding a valid hash that meets the mining difficulty level. The nonce search is delegated to SPHINXMiner::MiningEngine, which spreads it over all cores. A mined block is connected to MiningOptions::utxoStore when one is given.
+    // connect / disconnect: Apply the block to, or roll it back from, a long-lived UtxoStore (rollback uses the store's per-block undo data).
     // toJson: Converts the block object to a JSON format.
-    // fromJson: Parses a JSON object and assigns values to the corresponding member variables.
-    // save: Saves the block data to a file in JSON format.
-    // load: Loads a block from a file and initializes a new Block object from the JSON data.
-    // saveToDatabase: Saves the block data to a distributed database as a JSON string.
-    // loadFromDatabase: Loads a block from the distributed database and initializes a new Block object from the JSON data.
+    // fromJson: Parses a JSON object and assigns values to the corresponding member variables. The std::istream overload streams the fields in with the SAX reader from BlockJsonReader.hpp instead of building a JSON DOM.
+    // toBinary: Converts the block object to the compact binary format described in BlockCodec.hpp; hash fields that could not be read back are refused.
+    // fromBinary: Assigns the member variables from a zero-copy BlockReader over binary block data.
+    // serialize / deserialize: Encode a block in the binary (default) or JSON debug format, and decode either format by detecting the binary magic. JSON is decoded with the streaming SAX reader.
+    // Header-only loads (deserialize, load, loadFromDatabase, fromBinary): Skip the transactions for callers that only need the header fields and the block hash.
+    // save: Saves the block data to a file in binary format (or JSON when requested), optionally as a compressed record (see BlockCompression.hpp).
+    // load: Loads a block from a file in either format, compressed or not, and initializes a new Block object from it.
+    // save / load (BlockStore overloads): Append the block to, or read it back from, the segmented memory-mapped BlockStore.
+    // saveToDatabase: Saves the block data to a distributed database in binary format (or JSON when requested), optionally compressed.
+    // loadFromDatabase: Loads a block from the distributed database in either format, compressed or not, and initializes a new Block object from it.
     // getStoredMerkleRoot and getStoredSignature: Getter functions to retrieve the stored Merkle root and signature.
 
+// Instrumentation:
+    // The hashing, signing, verification, mining, save/load and database functions are timed with SPHINXBLOCK_TIME_OP (see BlockMetrics.hpp), which compiles to nothing with SPHINXBLOCK_NO_METRICS.
+
 // The Block class provides functionalities to handle block data, calculate block hashes, construct Merkle trees, mine blocks, sign and verify block signatures, serialize block data to JSON format, and store and retrieve blocks from a distributed database.
     
 // The code represents a simplified implementation of a blockchain system with functionality related to block creation, verification, mining, Merkle tree construction, and database interaction.
@@ -64,6 +81,7 @@
 
 
 
+#include <cstdint>
 #include <stdexcept>
 #include <fstream> 
 #include <iostream>
@@ -72,11 +90,13 @@
 #include <vector>
 #include <array>
 #include <map>
+#include <iterator>
+#include <string_view>
 
 #include "Block.hpp"
 #include "Hash.hpp"
 #include "Sign.hpp"
-#include "json.hh"
+#include "json.hpp"
 #include "MerkleBlock.hpp"
 #include "Transaction.hpp"
 #include "Chain.hpp"
@@ -87,6 +107,16 @@
 #include "Key.hpp"
 #include "Params.hpp"
 #include "Utxo.hpp"
+#include "Miner.hpp"
+#include "BlockHeader.hpp"
+#include "BlockCodec.hpp"
+#include "BlockCompression.hpp"
+#include "BlockStore.hpp"
+#include "MerkleAccumulator.hpp"
+#include "TransactionArena.hpp"
+#include "BlockJsonReader.hpp"
+#include "UtxoStore.hpp"
+#include "BlockMetrics.hpp"
 
 
 using json = nlohmann::json;
@@ -97,326 +127,549 @@ namespace SPHINXHash {
 
 namespace SPHINXMerkleBlock {
     class MerkleBlock; // Forward declaration of the MerkleBlock class
-
-    // Correct the constructMerkleTree function declaration
-    std::string constructMerkleTree(const std::vector<SPHINXTrx::Transaction>& signedTransactions);
 }
 
 namespace SPHINXBlock {
-    class Block {
-    private:
-        // Private member variables
-        std::string previousHash_;               // The hash of the previous block in the blockchain
-        std::string merkleRoot_;                 // The Merkle root hash of the transactions in the block
-        std::string signature_;                  // The signature of the block
-        uint32_t blockHeight_;                   // The position of the block within the blockchain
-        std::time_t timestamp_;                  // The time when the block was created
-        uint32_t nonce_;                         // A random value used in the mining process to find a valid block hash
-        uint32_t difficulty_;                    // A measure of how hard it is to find a valid block hash (mining difficulty)
-        std::vector<std::string> transactions_;  // The list of transactions included in the block
-        SPHINXChain::Chain* blockchain_;         // A pointer to the blockchain (assuming SPHINXChain::Chain is a class)
-        const std::vector<std::string>& checkpointBlocks_; // Reference to the list of checkpoint blocks
-
-        // Private member variables to store Merkle root and signature
-        std::string storedMerkleRoot_;
-        std::string storedSignature_;
-
-    public:
-        static const uint32_t MAX_BLOCK_SIZE = 1000;       // Maximum allowed block size in number of transactions
-        static const uint32_t MAX_TIMESTAMP_OFFSET = 600;  // Maximum allowed timestamp difference from current time
-
-        // Constructors
-        Block(const std::string& previousHash)
-            : previousHash_(previousHash), blockHeight_(0), nonce_(0), difficulty_(0) {
-            timestamp_ = std::time(nullptr); // Set the timestamp to the current time
+    namespace {
+        // Checkpoint list used by blocks constructed without one
+        const std::vector<std::string> noCheckpointBlocks;
+
+        // Hash fields are stored lowercase, the only form decodeDigest and the readers accept
+        std::string lowercaseHash(std::string hash) {
+            for (char& c : hash) {
+                if (c >= 'A' && c <= 'F') {
+                    c = static_cast<char>(c - 'A' + 'a');
+                }
+            }
+            return hash;
         }
 
-        Block(const std::string& previousHash, const std::vector<std::string>& checkpointBlocks)
-            : previousHash_(previousHash), checkpointBlocks_(checkpointBlocks), blockHeight_(0), nonce_(0), difficulty_(0) {
-            timestamp_ = std::time(nullptr); // Set the timestamp to the current time
+        // The readers reject a hash field that is not canonical, so refuse to write one that could not be loaded
+        void requireEncodableHashes(const std::string& previousHash, const std::string& merkleRoot) {
+            if (!isCanonicalHash(previousHash) || !isCanonicalHash(merkleRoot)) {
+                throw std::runtime_error("Cannot encode block: previousHash and merkleRoot must be 64-character lowercase hex hashes");
+            }
         }
 
-        // Function to add a transaction to the block
-        void addTransaction(const std::string& transaction) {
-            transactions_.push_back(transaction);
+        // Read an integer field, rejecting values the member cannot hold instead of letting get<>() wrap them
+        int64_t integerFromJson(const json& value, const char* field, int64_t min, int64_t max) {
+            if (!value.is_number_integer()) {
+                throw std::runtime_error(std::string("Malformed JSON block: unexpected type for field ") + field);
+            }
+            const bool fits = value.is_number_unsigned() ? value.get<uint64_t>() <= static_cast<uint64_t>(max)
+                                                         : value.get<int64_t>() >= min && value.get<int64_t>() <= max;
+            if (!fits) {
+                throw std::runtime_error(std::string("Malformed JSON block: value out of range for field ") + field);
+            }
+            return value.get<int64_t>();
         }
+    }
 
-        // Function to calculate the block hash
-        std::string calculateBlockHash() const {
-            // Concatenate all the data elements that uniquely identify the block
-            std::string blockData = previousHash_ + std::to_string(timestamp_);
+    const uint32_t Block::MAX_BLOCK_SIZE = 1000;       // Maximum allowed block size in number of transactions
+    const uint32_t Block::MAX_TIMESTAMP_OFFSET = 600;  // Maximum allowed timestamp difference from current time
 
-            for (const auto& transaction : transactions_) {
-                blockData += transaction;
-            }
+    // Constructors
+    Block::Block(const std::string& previousHash)
+        : previousHash_(lowercaseHash(previousHash)), blockHeight_(0), nonce_(0), difficulty_(0), blockchain_(nullptr), checkpointBlocks_(noCheckpointBlocks) {
+        timestamp_ = std::time(nullptr); // Set the timestamp to the current time
+        merkleRoot_ = merkleTree_.getRoot(); // Commit to the (empty) transaction list until a root is set
+    }
 
-            // Calculate the SPHINX_256 hash of the block data
-            std::string blockHash = SPHINXHash::SPHINX_256(blockData);
+    Block::Block(const std::string& previousHash, const std::vector<std::string>& checkpointBlocks)
+        : previousHash_(lowercaseHash(previousHash)), blockHeight_(0), nonce_(0), difficulty_(0), blockchain_(nullptr), checkpointBlocks_(checkpointBlocks) {
+        timestamp_ = std::time(nullptr); // Set the timestamp to the current time
+        merkleRoot_ = merkleTree_.getRoot(); // Commit to the (empty) transaction list until a root is set
+    }
 
-            return blockHash;
-        }
+    // Function to add a transaction to the block
+    void Block::addTransaction(const std::string& transaction) {
+        transactions_.append(transaction);
+        merkleTree_.append(transaction); // Rehash only the path from the new leaf to the root
+    }
 
-        // Function to calculate the Merkle root
-        std::string calculateMerkleRoot() const {
-            return SPHINXMerkleBlock::constructMerkleTree(transactions_);
-        }
+    // Function to add a transaction to the block, taking ownership of the caller's string
+    void Block::addTransaction(std::string&& transaction) {
+        transactions_.append(transaction);
+        merkleTree_.append(transaction);
+        std::string().swap(transaction); // Release the caller's buffer; the bytes now live in the arena
+    }
 
-        // Function to sign the Merkle root with SPHINCS+ private key and store the signature
-        void signMerkleRoot(const SPHINXPrivKey& privateKey, const std::string& merkleRoot) {
-            // SPHINCS+ signing function is available in the "Sign.hpp"
-            signature_ = SPHINXSign::sign_data(merkleRoot, privateKey);
-            storedMerkleRoot_ = merkleRoot;
-        }
+    // Function to replace a transaction in place
+    void Block::replaceTransaction(std::size_t index, std::string_view transaction) {
+        transactions_.replace(index, transaction);
+        merkleTree_.replace(index, transaction); // Rehash only the path from the replaced leaf to the root
+    }
 
-        // Function to verify the block's signature with the given public key
-        bool verifySignature(const SPHINXPubKey& publicKey) const {
-            // Calculate the block hash
-            std::string blockHash = calculateBlockHash();
+    // Function to build the fixed-size binary header (commits to the transactions through merkleRoot_)
+    HeaderBytes Block::serializeHeader() const {
+        return encodeHeader(previousHash_, merkleRoot_, blockHeight_, timestamp_, difficulty_, nonce_);
+    }
 
-            // Assuming the SPHINCS+ verification function is available in the library
-            return SPHINXSign::verify_data(blockHash, signature_, publicKey);
-        }
+    // Function to extract the compact header (the fields serializeHeader commits to)
+    BlockHeader Block::getHeader() const {
+        BlockHeader header;
+        header.previousHash = decodeDigest(previousHash_);
+        header.merkleRoot = decodeDigest(merkleRoot_);
+        header.timestamp = static_cast<int64_t>(timestamp_);
+        header.blockHeight = blockHeight_;
+        header.nonce = nonce_;
+        header.difficulty = difficulty_;
+        return header;
+    }
 
-        // Function to verify the block's Merkle root with the given public key
-        bool verifyMerkleRoot(const SPHINXPubKey& publicKey) const {
-            return merkleBlock.verifyMerkleRoot(storedMerkleRoot_, transactions_);
-        }
+    // Function to calculate the block hash
+    std::string Block::calculateBlockHash() const {
+        SPHINXBLOCK_TIME_OP(CalculateBlockHash);
+        // Hash the binary header; the cost is the same whatever the number of transactions
+        HeaderHasher hasher(serializeHeader());
+        return hasher.hashNonce(nonce_);
+    }
 
-        // Function to verify the entire block with the given public key
-        bool verifyBlock(const SPHINXPubKey& publicKey) const {
-            // Call the verifySignature and verifyMerkleRoot functions
-            return verifySignature(publicKey) && verifyMerkleRoot(publicKey);
-        }
+    // Function to calculate the Merkle root
+    std::string Block::calculateMerkleRoot() const {
+        SPHINXBLOCK_TIME_OP(CalculateMerkleRoot);
+        // The tree is kept up to date by addTransaction/setTransactions, so this is just the cached root
+        return merkleTree_.getRoot();
+    }
 
-        // Function to mine the block with the given difficulty
-        bool mineBlock(uint32_t difficulty) {
-            std::string target(difficulty, '0');  // Create a target string with the specified difficulty level
+    // Function to build the Merkle inclusion proof of the transaction at the given index
+    MerkleProof Block::getMerkleProof(std::size_t transactionIndex) const {
+        return merkleTree_.getProof(transactionIndex);
+    }
 
-            while (true) {
-                nonce_++;  // Increment the nonce
+    // Function to sign the Merkle root with SPHINCS+ private key and store the signature
+    std::string Block::signMerkleRoot(const SPHINXPrivKey& privateKey, const std::string& merkleRoot) {
+        SPHINXBLOCK_TIME_OP(SignMerkleRoot);
+        // SPHINCS+ signing function is available in the "Sign.hpp"
+        signature_ = SPHINXSign::sign_data(merkleRoot, privateKey);
+        storedMerkleRoot_ = merkleRoot;
+        storedSignature_ = signature_;
+        return signature_;
+    }
 
-                // Calculate the block hash
-                std::string blockHash = calculateBlockHash();
+    // Function to store the Merkle root and signature in the header of the block
+    void Block::storeMerkleRootAndSignature(const std::string& merkleRoot, const std::string& signature) {
+        merkleRoot_ = lowercaseHash(merkleRoot);
+        blockHash_.invalidate();
+        signature_ = signature;
+        storedMerkleRoot_ = merkleRoot;
+        storedSignature_ = signature;
+    }
 
-                // Check if the block hash meets the target difficulty
-                if (blockHash.substr(0, difficulty) == target) {
-                    // Block successfully mined
+    // Get the hash of the block; calculateBlockHash() runs only on the first call after a header change
+    std::string Block::getBlockHash() const {
+        return blockHash_.get([this]() { return calculateBlockHash(); });
+    }
 
-                    //*
-                    // UTXO function used in the mineBlock function in this version of block.cpp. 
-                    // The mineBlock function is responsible for mining a block by finding a valid hash 
-                    // that meets the required difficulty level. When a block is successfully mined, 
-                    // the mineBlock function updates the UTXO set based on the transactions included 
-                    // in the block. The UTXO set represents the unspent transaction outputs, and 
-                    // updating it is an essential part of the blockchain's functioning to ensure the 
-                    // correctness of transactions.
-                    //*
+    // Function to verify the block's signature with the given public key
+    bool Block::verifySignature(const SPHINXPubKey& publicKey) const {
+        // Get the (memoized) block hash
+        std::string blockHash = getBlockHash();
 
-                    // Update the UTXO set based on the transactions in the block
-                    std::map<std::string, SPHINXUtxo::UTXO> utxoSet; // Assuming you have access to the UTXO set
-                    SPHINXUtxo::updateUTXOSet(*this, utxoSet);
+        // Assuming the SPHINCS+ verification function is available in the library
+        return SPHINXSign::verify_data(blockHash, signature_, publicKey);
+    }
 
-                    return true;
-                }
-            }
+    // Function to verify the block's Merkle root with the given public key
+    bool Block::verifyMerkleRoot(const SPHINXPubKey& publicKey) const {
+        // Check the signed root if the block was signed here, otherwise the root stored in the header
+        const std::string& expectedRoot = storedMerkleRoot_.empty() ? merkleRoot_ : storedMerkleRoot_;
+        return expectedRoot == merkleTree_.getRoot();
+    }
 
-            // Block mining failed
+    // Function to verify the entire block with the given public key
+    bool Block::verifyBlock(const SPHINXPubKey& publicKey) const {
+        SPHINXBLOCK_TIME_OP(VerifyBlock);
+        // Call the verifySignature and verifyMerkleRoot functions
+        return verifySignature(publicKey) && verifyMerkleRoot(publicKey);
+    }
+
+    // Function to mine the block with the given difficulty
+    bool Block::mineBlock(uint32_t difficulty) {
+        return mineBlock(difficulty, SPHINXMiner::MiningOptions());
+    }
+
+    // Function to mine the block with the given difficulty, spreading the nonce search over worker threads
+    bool Block::mineBlock(uint32_t difficulty, const SPHINXMiner::MiningOptions& options) {
+        SPHINXBLOCK_TIME_OP(MineBlock);
+        // Make the header commit to the transactions currently in the block
+        merkleRoot_ = calculateMerkleRoot();
+        difficulty_ = difficulty;
+        blockHash_.invalidate();
+
+        SPHINXMiner::MiningEngine engine(options);
+        SPHINXMiner::MiningResult result = engine.mine(*this, difficulty);
+
+        if (!result.found) {
+            // Block mining failed (cancelled, out of time or search space exhausted)
             return false;
         }
 
-        // Setters and getters for the remaining member variables
-        void setMerkleRoot(const std::string& merkleRoot) {
-            merkleRoot_ = merkleRoot;
-        }
+        // Block successfully mined, adopt the winning nonce and (possibly rolled) timestamp
+        timestamp_ = result.timestamp;
+        nonce_ = result.nonce;
+        blockHash_.set(result.blockHash); // The miner already hashed the winning header
 
-        // Sets the signature of the block
-        void setSignature(const std::string& signature) {
-            signature_ = signature;
+        // Update the UTXO set based on the transactions in the block
+        if (options.utxoStore != nullptr) {
+            connect(*options.utxoStore);
+        } else {
+            std::map<std::string, SPHINXUtxo::UTXO> utxoSet; // No persistent set given; the module still sees the block
+            SPHINXUtxo::updateUTXOSet(*this, utxoSet);
         }
 
-        // Sets the block height (the position of the block within the blockchain)
-        void setBlockHeight(uint32_t blockHeight) {
-            blockHeight_ = blockHeight;
-        }
+        return true;
+    }
 
-        // Sets the nonce (a random value used in the mining process to find a valid block hash)
-        void setNonce(uint32_t nonce) {
-            nonce_ = nonce;
-        }
+    // Function to apply the block's transactions to a persistent UTXO set
+    void Block::connect(UtxoStore& utxoStore) const {
+        utxoStore.connectBlock(*this);
+    }
 
-        // Sets the difficulty level of mining (a measure of how hard it is to find a valid block hash)
-        void setDifficulty(uint32_t difficulty) {
-            difficulty_ = difficulty;
-        }
+    // Function to roll the block's transactions back from a persistent UTXO set (the block must be its tip)
+    void Block::disconnect(UtxoStore& utxoStore) const {
+        utxoStore.disconnectBlock(*this);
+    }
 
-        // Sets the transactions included in the block
-        void setTransactions(const std::vector<std::string>& transactions) {
-            transactions_ = transactions;
-        }
+    // Setters and getters for the remaining member variables
+    void Block::setPreviousHash(const std::string& previousHash) {
+        previousHash_ = lowercaseHash(previousHash);
+        blockHash_.invalidate();
+    }
 
-        // Returns the previous hash (the hash of the previous block in the blockchain)
-        std::string getPreviousHash() const {
-            return previousHash_;
-        }
+    // Sets the Merkle root of the block
+    void Block::setMerkleRoot(const std::string& merkleRoot) {
+        merkleRoot_ = merkleRoot;
+        blockHash_.invalidate();
+    }
 
-        // Returns the Merkle root (the root hash of the Merkle tree constructed from the transactions)
-        std::string getMerkleRoot() const {
-            return merkleRoot_;
-        }
+    // Sets the signature of the block
+    void Block::setSignature(const std::string& signature) {
+        signature_ = signature;
+    }
 
-        // Returns the signature of the block
-        std::string getSignature() const {
-            return signature_;
-        }
+    // Sets the block height (the position of the block within the blockchain)
+    void Block::setBlockHeight(uint32_t blockHeight) {
+        blockHeight_ = blockHeight;
+        blockHash_.invalidate();
+    }
 
-        // Returns the block height (the position of the block within the blockchain)
-        uint32_t getBlockHeight() const {
-            return blockHeight_;
-        }
+    // Sets the timestamp (the time when the block was created)
+    void Block::setTimestamp(std::time_t timestamp) {
+        timestamp_ = timestamp;
+        blockHash_.invalidate();
+    }
+
+    // Sets the nonce (a random value used in the mining process to find a valid block hash)
+    void Block::setNonce(uint32_t nonce) {
+        nonce_ = nonce;
+        blockHash_.invalidate();
+    }
+
+    // Sets the difficulty level of mining (a measure of how hard it is to find a valid block hash)
+    void Block::setDifficulty(uint32_t difficulty) {
+        difficulty_ = difficulty;
+        blockHash_.invalidate();
+    }
+
+    // Sets the transactions included in the block
+    void Block::setTransactions(const std::vector<std::string>& transactions) {
+        transactions_.assign(transactions);
+        merkleTree_.rebuild(transactions);
+    }
+
+    // Sets the transactions included in the block, taking ownership of the caller's vector
+    void Block::setTransactions(std::vector<std::string>&& transactions) {
+        merkleTree_.rebuild(transactions);
+        transactions_.assign(transactions);
+        std::vector<std::string>().swap(transactions); // Release the per-transaction allocations
+    }
+
+    // Sets the transactions included in the block, adopting an already filled arena
+    void Block::setTransactions(TransactionArena&& transactions) {
+        transactions_ = std::move(transactions);
+        merkleTree_.rebuild(transactions_);
+    }
+
+    // Returns the previous hash (the hash of the previous block in the blockchain)
+    std::string Block::getPreviousHash() const {
+        return previousHash_;
+    }
+
+    // Returns the Merkle root (the root hash of the Merkle tree constructed from the transactions)
+    std::string Block::getMerkleRoot() const {
+        return merkleRoot_;
+    }
+
+    // Returns the signature of the block
+    std::string Block::getSignature() const {
+        return signature_;
+    }
+
+    // Returns the block height (the position of the block within the blockchain)
+    uint32_t Block::getBlockHeight() const {
+        return blockHeight_;
+    }
+
+    // Returns the timestamp (the time when the block was created)
+    std::time_t Block::getTimestamp() const {
+        return timestamp_;
+    }
+
+    // Returns the nonce (a random value used in the mining process to find a valid block hash)
+    uint32_t Block::getNonce() const {
+        return nonce_;
+    }
+
+    // Returns the difficulty level of mining (a measure of how hard it is to find a valid block hash)
+    uint32_t Block::getDifficulty() const {
+        return difficulty_;
+    }
+
+    // Returns the transactions included in the block
+    std::vector<std::string> Block::getTransactions() const {
+        return transactions_.toVector();
+    }
+
+    // Returns the transactions without copying them (views stay valid until the block is modified)
+    const TransactionArena& Block::getTransactionArena() const {
+        return transactions_;
+    }
+
+    // Returns a view of the transaction at the given index
+    std::string_view Block::getTransaction(std::size_t index) const {
+        return transactions_.at(index);
+    }
+
+    // Returns the number of transactions included in the block
+    std::size_t Block::getTransactionCount() const {
+        return transactions_.size();
+    }
+
+    // Block headers
+    nlohmann::json Block::toJson() const {
+        // Convert the block object to JSON format
+        nlohmann::json blockJson;
 
-        // Returns the timestamp (the time when the block was created)
-        std::time_t getTimestamp() const {
-            return timestamp_;
+        blockJson["previousHash"] = previousHash_;     // Store the previous hash in the JSON object
+        blockJson["merkleRoot"] = merkleRoot_;         // Store the Merkle root in the JSON object
+        blockJson["signature"] = signature_;           // Store the signature in the JSON object
+        blockJson["blockHeight"] = blockHeight_;       // Store the block height in the JSON object
+        blockJson["timestamp"] = timestamp_;           // Store the timestamp in the JSON object
+        blockJson["nonce"] = nonce_;                   // Store the nonce in the JSON object
+        blockJson["difficulty"] = difficulty_;         // Store the difficulty in the JSON object
+
+        nlohmann::json transactionsJson = nlohmann::json::array();
+        for (std::string_view transaction : transactions_) {
+            transactionsJson.push_back(std::string(transaction));  // Store each transaction in the JSON array
         }
+        blockJson["transactions"] = transactionsJson;  // Store the transactions array in the JSON object
+
+        return blockJson;                              // Return the JSON object
+    }
+
+    void Block::fromJson(const nlohmann::json& blockJson) {
+        // Parse the JSON object and assign values to the corresponding member variables
+        previousHash_ = blockJson["previousHash"].get<std::string>();     // Retrieve the previous hash from the JSON object
+        merkleRoot_ = blockJson["merkleRoot"].get<std::string>();         // Retrieve the Merkle root from the JSON object
+        signature_ = blockJson["signature"].get<std::string>();           // Retrieve the signature from the JSON object
+        blockHeight_ = static_cast<uint32_t>(integerFromJson(blockJson["blockHeight"], "blockHeight", 0, UINT32_MAX));  // Retrieve the block height from the JSON object
+        timestamp_ = static_cast<std::time_t>(integerFromJson(blockJson["timestamp"], "timestamp", INT64_MIN, INT64_MAX)); // Retrieve the timestamp from the JSON object
+        nonce_ = static_cast<uint32_t>(integerFromJson(blockJson["nonce"], "nonce", 0, UINT32_MAX));                      // Retrieve the nonce from the JSON object
+        difficulty_ = static_cast<uint32_t>(integerFromJson(blockJson["difficulty"], "difficulty", 0, UINT32_MAX));       // Retrieve the difficulty from the JSON object
+        blockHash_.invalidate();
+        if (!isCanonicalHash(previousHash_) || !isCanonicalHash(merkleRoot_)) {
+            throw std::runtime_error("Malformed JSON block: previousHash and merkleRoot must be 64-character lowercase hex hashes");
+        }
+
+        transactions_.clear();
+        const json& transactionsJson = blockJson["transactions"];
+        for (const auto& transactionJson : transactionsJson) {
+            transactions_.append(transactionJson.get_ref<const std::string&>());  // Retrieve each transaction from the JSON array
+        }
+        merkleTree_.rebuild(transactions_);
+    }
 
-        // Returns the nonce (a random value used in the mining process to find a valid block hash)
-        uint32_t getNonce() const {
-            return nonce_;
+    void Block::fromJson(std::istream& input, bool headerOnly) {
+        // Stream the fields in without building a JSON DOM (see BlockJsonReader.hpp)
+        readJsonBlock(input, *this, headerOnly);
+    }
+
+    // Compact binary encoding (see BlockCodec.hpp for the layout)
+    std::string Block::toBinary() const {
+        requireEncodableHashes(previousHash_, merkleRoot_);
+
+        std::string blockData;
+        BinaryEncoder encoder(blockData);
+
+        encoder.writeHeader();                         // Magic and format version
+        encoder.writeString(previousHash_);            // Store the previous hash
+        encoder.writeString(merkleRoot_);              // Store the Merkle root
+        encoder.writeString(signature_);               // Store the signature
+        encoder.writeUint32(blockHeight_);             // Store the block height
+        encoder.writeInt64(timestamp_);                // Store the timestamp
+        encoder.writeUint32(nonce_);                   // Store the nonce
+        encoder.writeUint32(difficulty_);              // Store the difficulty
+
+        encoder.writeUint32(static_cast<uint32_t>(transactions_.size()));
+        for (std::string_view transaction : transactions_) {
+            encoder.writeBytes(transaction);           // Store each transaction, length-prefixed
         }
 
-        // Returns the difficulty level of mining (a measure of how hard it is to find a valid block hash)
-        uint32_t getDifficulty() const {
-            return difficulty_;
+        return blockData;
+    }
+
+    void Block::fromBinary(const BlockReader& reader, bool headerOnly) {
+        // Copy the fields out of the zero-copy reader
+        previousHash_ = reader.getPreviousHash();
+        merkleRoot_ = reader.getMerkleRoot();
+        signature_ = reader.getSignature();
+        blockHeight_ = reader.getBlockHeight();
+        timestamp_ = reader.getTimestamp();
+        nonce_ = reader.getNonce();
+        difficulty_ = reader.getDifficulty();
+        blockHash_.invalidate();
+
+        transactions_.clear();
+        if (headerOnly) {
+            merkleTree_.clear();
+            return;
         }
 
-        // Returns the transactions included in the block
-        std::vector<std::string> getTransactions() const {
-            return transactions_;
+        std::size_t byteCount = 0;
+        for (std::string_view transaction : reader.getTransactionViews()) {
+            byteCount += transaction.size();
         }
 
-        Block::Block(const std::string& prevBlockHash, const std::string& timestamp, const std::string& nonce, const std::vector<Transaction>& transactions) {
-            this->previousHash_ = prevBlockHash;
-            this->timestamp_ = timestamp;
-            this->nonce_ = nonce;
-            this->transactions_ = transactions;
+        transactions_.reserve(reader.getTransactionCount(), byteCount); // One allocation for all transaction bytes
+        for (std::string_view transaction : reader.getTransactionViews()) {
+            transactions_.append(transaction);
+        }
+        merkleTree_.rebuild(transactions_);
+    }
 
-            // Merkle tree construction function is already implemented in "MerkleBlock.cpp"
-            std::string merkleRoot = SPHINXMerkleBlock::constructMerkleTree(transactions);
-            this->setMerkleRoot(merkleRoot); // Set the Merkle root for this block
+    // Encode the block in the requested format
+    std::string Block::serialize(BlockFormat format) const {
+        if (format == BlockFormat::Json) {
+            requireEncodableHashes(previousHash_, merkleRoot_); // toJson itself stays usable for inspecting such a block
+            return toJson().dump(4);
         }
+        return toBinary();
+    }
 
-        // Block headers
-        nlohmann::json toJson() const {
-            // Convert the block object to JSON format
-            nlohmann::json blockJson;
-
-            blockJson["previousHash"] = previousHash_;     // Store the previous hash in the JSON object
-            blockJson["merkleRoot"] = merkleRoot_;         // Store the Merkle root in the JSON object
-            blockJson["signature"] = signature_;           // Store the signature in the JSON object
-            blockJson["blockHeight"] = blockHeight_;       // Store the block height in the JSON object
-            blockJson["timestamp"] = timestamp_;           // Store the timestamp in the JSON object
-            blockJson["nonce"] = nonce_;                   // Store the nonce in the JSON object
-            blockJson["difficulty"] = difficulty_;         // Store the difficulty in the JSON object
-
-            nlohmann::json transactionsJson = nlohmann::json::array();
-            for (const std::string& transaction : transactions_) {
-                transactionsJson.push_back(transaction);   // Store each transaction in the JSON array
-            }
-            blockJson["transactions"] = transactionsJson;  // Store the transactions array in the JSON object
+    // Decode a block from either format; binary blocks and compressed records are recognised by their magic bytes
+    Block Block::deserialize(std::string_view blockData, bool headerOnly) {
+        if (isCompressedBlock(blockData)) {
+            return deserialize(decompressBlock(blockData), headerOnly);
+        }
 
-            return blockJson;                              // Return the JSON object
+        Block block("");
+        if (isBinaryBlock(blockData)) {
+            block.fromBinary(BlockReader(blockData), headerOnly);
+        } else {
+            readJsonBlock(blockData, block, headerOnly); // SAX parse, no JSON DOM
         }
+        return block;
+    }
 
-        void fromJson(const nlohmann::json& blockJson) {
-            // Parse the JSON object and assign values to the corresponding member variables
-            previousHash_ = blockJson["previousHash"].get<std::string>();     // Retrieve the previous hash from the JSON object
-            merkleRoot_ = blockJson["merkleRoot"].get<std::string>();         // Retrieve the Merkle root from the JSON object
-            signature_ = blockJson["signature"].get<std::string>();           // Retrieve the signature from the JSON object
-            blockHeight_ = blockJson["blockHeight"].get<uint32_t>();          // Retrieve the block height from the JSON object
-            timestamp_ = blockJson["timestamp"].get<std::time_t>();           // Retrieve the timestamp from the JSON object
-            nonce_ = blockJson["nonce"].get<uint32_t>();                      // Retrieve the nonce from the JSON object
-            difficulty_ = blockJson["difficulty"].get<uint32_t>();            // Retrieve the difficulty from the JSON object
-
-            transactions_.clear();
-            const json& transactionsJson = blockJson["transactions"];
-            for (const auto& transactionJson : transactionsJson) {
-                transactions_.push_back(transactionJson.get<std::string>());  // Retrieve each transaction from the JSON array
-            }
+    bool Block::save(const std::string& filename, BlockFormat format, const BlockCompressor* compressor) const {
+        SPHINXBLOCK_TIME_OP(Save);
+        // Encode the block (binary by default, JSON for debugging), compressed if a codec is given
+        std::string blockData = serialize(format);
+        if (compressor != nullptr) {
+            blockData = compressBlock(blockData, *compressor);
         }
 
-        bool save(const std::string& filename) const {
-            // Convert the block object to JSON format
-            nlohmann::json blockJson = toJson();
-
-            // Open the output file stream
-            std::ofstream outputFile(filename);
-            if (outputFile.is_open()) {
-                // Write the JSON data to the file with indentation
-                outputFile << blockJson.dump(4);
-                outputFile.close();
-                return true; // Return true to indicate successful save
-            }
-            return false; // Return false to indicate failed save
+        // Open the output file stream
+        std::ofstream outputFile(filename, std::ios::binary);
+        if (outputFile.is_open()) {
+            // Write the encoded block to the file
+            outputFile.write(blockData.data(), static_cast<std::streamsize>(blockData.size()));
+            outputFile.close();
+            return static_cast<bool>(outputFile); // Return true to indicate successful save
         }
+        return false; // Return false to indicate failed save
+    }
 
-        static Block load(const std::string& filename) {
-            // Open the input file stream
-            std::ifstream inputFile(filename);
-            if (inputFile.is_open()) {
-                // Parse the JSON data from the file
-                nlohmann::json blockJson;
-                inputFile >> blockJson;
-                inputFile.close();
-
-                // Create a new block object and initialize it from the parsed JSON
-                Block loadedBlock("");
-                loadedBlock.fromJson(blockJson);
-                return loadedBlock; // Return the loaded block
+    Block Block::load(const std::string& filename, bool headerOnly) {
+        SPHINXBLOCK_TIME_OP(Load);
+        // Open the input file stream
+        std::ifstream inputFile(filename, std::ios::binary);
+        if (inputFile.is_open()) {
+            // Detect the format from the leading bytes
+            char magic[sizeof(BINARY_MAGIC)] = {};
+            inputFile.read(magic, sizeof(magic));
+            const std::string_view leading(magic, static_cast<std::size_t>(inputFile.gcount()));
+            inputFile.clear();
+            inputFile.seekg(0);
+
+            if (!isBinaryBlock(leading) && !isCompressedBlock(leading)) {
+                // JSON files are parsed straight from the stream
+                Block block("");
+                block.fromJson(inputFile, headerOnly);
+                return block;
             }
-            throw std::runtime_error("Failed to load block from file: " + filename); // Throw an exception if the file could not be opened
-        }
 
-        bool saveToDatabase(SPHINXDb::DistributedDb& distributedDb) const {
-            // Convert the block object to JSON format
-            nlohmann::json blockJson = toJson();
+            std::string blockData((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+            inputFile.close();
+
+            return deserialize(blockData, headerOnly); // Return the loaded block
+        }
+        throw std::runtime_error("Failed to load block from file: " + filename); // Throw an exception if the file could not be opened
+    }
 
-            // Get the block hash as the database key
-            std::string blockId = getBlockHash();
+    bool Block::save(BlockStore& blockStore) const {
+        SPHINXBLOCK_TIME_OP(Save);
+        // Append the block to the segmented block store instead of writing a file of its own
+        blockStore.append(*this);
+        return true;
+    }
 
-            // Convert the JSON data to a string
-            std::string blockData = blockJson.dump();
+    Block Block::load(const BlockStore& blockStore, const std::string& blockHash) {
+        SPHINXBLOCK_TIME_OP(Load);
+        // Decode the block straight from the store's memory-mapped segment
+        return blockStore.loadByHash(blockHash);
+    }
 
-            // Save the block data to the distributed database
-            distributedDb.saveData(blockData, blockId);
+    bool Block::saveToDatabase(SPHINXDb::DistributedDb& distributedDb, BlockFormat format, const BlockCompressor* compressor) const {
+        SPHINXBLOCK_TIME_OP(SaveToDatabase);
+        // Get the block hash as the database key
+        std::string blockId = getBlockHash();
 
-            return true;
+        // Encode the block (binary by default, JSON for debugging), compressed if a codec is given
+        std::string blockData = serialize(format);
+        if (compressor != nullptr) {
+            blockData = compressBlock(blockData, *compressor);
         }
 
-        static Block loadFromDatabase(const std::string& blockId, SPHINXDb::DistributedDb& distributedDb) {
-            std::string blockData = distributedDb.loadData(blockId); // Load the block data from the distributed database
-            nlohmann::json blockJson = nlohmann::json::parse(blockData); // Parse the JSON string
+        // Save the block data to the distributed database
+        distributedDb.saveData(blockData, blockId);
 
-            Block loadedBlock("");
-            loadedBlock.fromJson(blockJson); // Initialize the block from the JSON
-            return loadedBlock;
-        }
+        return true;
+    }
 
-        // Getter functions to retrieve the stored Merkle root and signature
-        std::string getStoredMerkleRoot() const {
-            return storedMerkleRoot_;
-        }
+    Block Block::loadFromDatabase(const std::string& blockId, SPHINXDb::DistributedDb& distributedDb, bool headerOnly) {
+        SPHINXBLOCK_TIME_OP(LoadFromDatabase);
+        std::string blockData = distributedDb.loadData(blockId); // Load the block data from the distributed database
+        return deserialize(blockData, headerOnly); // Decode the binary, JSON or compressed record without a JSON DOM
+    }
 
-        std::string getStoredSignature() const {
-            return storedSignature_;
-        }
-    };
+    // Getter functions to retrieve the stored Merkle root and signature
+    std::string Block::getStoredMerkleRoot() const {
+        return storedMerkleRoot_;
+    }
+
+    std::string Block::getStoredSignature() const {
+        return storedSignature_;
+    }
 } // namespace SPHINXBlock
 
 
+#ifndef SPHINXBLOCK_NO_DEMO_MAIN
 //Usage
 int main() {
     // Create a new block with a previous hash
-    std::string previousHash = "00000000000000000000000000000000"; // A placeholder for the previous block's hash
+    std::string previousHash(64, '0'); // A placeholder for the previous block's hash (64 lowercase hex characters)
     SPHINXBlock::Block block(previousHash);
 
     // Add transactions to the block
@@ -458,3 +711,4 @@ int main() {
 
     return 0;
 } // namespace SPHINXBlock
+#endif // SPHINXBLOCK_NO_DEMO_MAIN
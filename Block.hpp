@@ -28,10 +28,15 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <string_view>
 
 #include "json.hpp"
 #include "Params.hpp"
 #include "MerkleBlock.hpp"
+#include "BlockHeader.hpp"
+#include "BlockCodec.hpp"
+#include "MerkleAccumulator.hpp"
+#include "TransactionArena.hpp"
 
 
 using json = nlohmann::json;
@@ -54,7 +59,16 @@ namespace SPHINXDb {
     class DistributedDb; // Forward declaration of the DistributedDb class
 }
 
+// Forward declarations
+namespace SPHINXMiner {
+    struct MiningOptions; // Forward declaration of the MiningOptions struct
+}
+
 namespace SPHINXBlock {
+    class BlockStore;      // Forward declaration of the BlockStore class
+    class UtxoStore;       // Forward declaration of the UtxoStore class
+    class BlockCompressor; // Forward declaration of the BlockCompressor class
+
     class Block {
     private:
         // Private member variables
@@ -65,10 +79,16 @@ namespace SPHINXBlock {
         std::time_t timestamp_;                  // The time when the block was created
         uint32_t nonce_;                         // A random value used in the mining process to find a valid block hash
         uint32_t difficulty_;                    // A measure of how hard it is to find a valid block hash (mining difficulty)
-        std::vector<std::string> transactions_;  // The list of transactions included in the block
+        TransactionArena transactions_;          // The list of transactions included in the block, stored contiguously
+        MerkleAccumulator merkleTree_;           // Cached Merkle tree levels over transactions_, updated incrementally
+        HashMemo blockHash_;                     // Memoized calculateBlockHash(), invalidated whenever a header field changes
         SPHINXChain::Chain* blockchain_;         // A pointer to the blockchain (assuming SPHINXChain::Chain is a class)
         const std::vector<std::string>& checkpointBlocks_; // Reference to the list of checkpoint blocks
 
+        // Private member variables to store Merkle root and signature
+        std::string storedMerkleRoot_;
+        std::string storedSignature_;
+
     public:
         static const uint32_t MAX_BLOCK_SIZE;       // Maximum allowed block size in number of transactions
         static const uint32_t MAX_TIMESTAMP_OFFSET; // Maximum allowed timestamp difference from current time
@@ -79,34 +99,63 @@ namespace SPHINXBlock {
         // Constructor with the addition of checkpointBlocks parameter
         Block(const std::string& previousHash, const std::vector<std::string>& checkpointBlocks);
 
+        // Function to build the fixed-size binary header of the block
+        HeaderBytes serializeHeader() const;
+
+        // Function to extract the compact, transaction-free header of the block
+        BlockHeader getHeader() const;
+
         // Function to calculate the hash of the block
         std::string calculateBlockHash() const;
 
         // Add a transaction to the list of transactions in the block
         void addTransaction(const std::string& transaction);
+        void addTransaction(std::string&& transaction);
+
+        // Replace the transaction at the given index, updating the Merkle tree in O(log n)
+        void replaceTransaction(std::size_t index, std::string_view transaction);
 
         // Calculate and return the Merkle root of the transactions
         std::string calculateMerkleRoot() const;
 
+        // Build the Merkle inclusion proof of the transaction at the given index
+        MerkleProof getMerkleProof(std::size_t transactionIndex) const;
+
         // Function to sign the Merkle root with SPHINCS+ private key
         std::string signMerkleRoot(const SPHINXPrivKey& privateKey, const std::string& merkleRoot);
 
         // Function to store the Merkle root and signature in the header of the block
         void storeMerkleRootAndSignature(const std::string& merkleRoot, const std::string& signature);
 
-        // Get the hash of the block by calling the calculateBlockHash() function
+        // Get the hash of the block, memoized until a header field changes
         std::string getBlockHash() const;
 
+        // Verify the block's signature (over the block hash) and its Merkle root separately
+        bool verifySignature(const SPHINXMerkleBlock::SPHINXPubKey& publicKey) const;
+        bool verifyMerkleRoot(const SPHINXMerkleBlock::SPHINXPubKey& publicKey) const;
+
         // Verify the block's signature and Merkle root
         bool verifyBlock(const SPHINXMerkleBlock::SPHINXPubKey& publicKey) const;
 
+        // Mine the block with the given difficulty, searching the nonce space on all available cores
+        bool mineBlock(uint32_t difficulty);
+        bool mineBlock(uint32_t difficulty, const SPHINXMiner::MiningOptions& options);
+
+        // Apply the block's transactions to, or roll them back from, a persistent UTXO set
+        void connect(UtxoStore& utxoStore) const;
+        void disconnect(UtxoStore& utxoStore) const;
+
         // Setters and getters for the remaining member variables
+        void setPreviousHash(const std::string& previousHash);
         void setMerkleRoot(const std::string& merkleRoot);
         void setSignature(const std::string& signature);
         void setBlockHeight(uint32_t blockHeight);
+        void setTimestamp(std::time_t timestamp);
         void setNonce(uint32_t nonce);
         void setDifficulty(uint32_t difficulty);
         void setTransactions(const std::vector<std::string>& transactions);
+        void setTransactions(std::vector<std::string>&& transactions);
+        void setTransactions(TransactionArena&& transactions);
         std::string getPreviousHash() const;
         std::string getMerkleRoot() const;
         std::string getSignature() const;
@@ -115,14 +164,32 @@ namespace SPHINXBlock {
         uint32_t getNonce() const;
         uint32_t getDifficulty() const;
         std::vector<std::string> getTransactions() const;
+        const TransactionArena& getTransactionArena() const;
+        std::string_view getTransaction(std::size_t index) const;
+        std::size_t getTransactionCount() const;
 
-        // Block headers
+        // Block headers (headerOnly loads skip the transactions and leave the block without them)
         nlohmann::json toJson() const;
         void fromJson(const nlohmann::json& blockJson);
-        bool save(const std::string& filename) const;
-        static Block load(const std::string& filename);
-        bool saveToDatabase(SPHINXDb::DistributedDb& distributedDb) const;
-        static Block loadFromDatabase(const std::string& blockId, SPHINXDb::DistributedDb& distributedDb);
+        void fromJson(std::istream& input, bool headerOnly = false);
+        // toBinary and serialize throw std::runtime_error unless previousHash and merkleRoot are canonical hashes
+        // (the constructors and setters lowercase them), so whatever is written can be read back
+        std::string toBinary() const;
+        void fromBinary(const BlockReader& reader, bool headerOnly = false);
+        std::string serialize(BlockFormat format = BlockFormat::Binary) const;
+        static Block deserialize(std::string_view blockData, bool headerOnly = false);
+        // With a compressor the encoded block is stored as a compressed record; loads detect and unwrap it
+        bool save(const std::string& filename, BlockFormat format = BlockFormat::Binary, const BlockCompressor* compressor = nullptr) const;
+        static Block load(const std::string& filename, bool headerOnly = false);
+        bool save(BlockStore& blockStore) const;
+        static Block load(const BlockStore& blockStore, const std::string& blockHash);
+        bool saveToDatabase(SPHINXDb::DistributedDb& distributedDb, BlockFormat format = BlockFormat::Binary,
+                            const BlockCompressor* compressor = nullptr) const;
+        static Block loadFromDatabase(const std::string& blockId, SPHINXDb::DistributedDb& distributedDb, bool headerOnly = false);
+
+        // Getter functions to retrieve the stored Merkle root and signature
+        std::string getStoredMerkleRoot() const;
+        std::string getStoredSignature() const;
     };
 } // namespace SPHINXBlock
 
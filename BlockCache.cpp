@@ -0,0 +1,280 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the BlockCache class, an in-memory cache of decoded blocks for the RPC and validation paths.
+
+// Sharding:
+    // Blocks are spread over shardCount shards by the hash of their block hash. Each shard is an LRU list plus a
+    // hash index under its own mutex and gets an equal part of the memory budget, so lookups of different blocks
+    // rarely contend. A height index maps each height to the hash of the block last inserted at that height.
+
+// Handles:
+    // Blocks are stored as std::shared_ptr<const Block>. Evicting a block only drops the cache's reference, so a
+    // handle held by a caller stays valid.
+
+// Chain tip:
+    // setTip pins a block outside the LRU; lookups by its hash or height are answered before any shard is
+    // touched and it can never be evicted, so loads of the tip never reach the disk or the database.
+
+// Keys:
+    // Hashes passed in are normalized to the lowercase form getBlockHash() returns, and a block produced by a
+    // loader is only cached if its own hash is the one requested, so the index never holds an entry that a
+    // later lookup for the same block would miss.
+
+// Size accounting:
+    // estimateSize approximates the heap footprint of a block from its transaction bytes, its offsets table and
+    // the cached Merkle levels; maxBytes bounds the sum of these estimates.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "BlockCache.hpp"
+#include "BlockHeader.hpp"
+#include "BlockStore.hpp"
+#include "db.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        constexpr std::size_t HASH_STRING_SIZE = 96;  // Heap bytes of one cached hex digest (64 chars + std::string)
+
+        // Lowercase form of a hex block hash (decodeDigest only accepts lowercase); a non-hash never matches
+        std::string normalizeHash(const std::string& blockHash) {
+            std::string normalized = blockHash;
+            std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return normalized;
+        }
+    }
+
+    BlockCache::BlockCache(const BlockCacheOptions& options)
+        : hits_(0), misses_(0), evictions_(0) {
+        const std::size_t shardCount = std::max<std::size_t>(options.shardCount, 1);
+        shardCapacity_ = std::max<std::size_t>(options.maxBytes / shardCount, 1);
+        shards_.reserve(shardCount);
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            shards_.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    std::size_t BlockCache::estimateSize(const Block& block) {
+        const std::size_t transactionCount = block.getTransactionCount();
+        // Leaves plus interior levels hold about twice as many digests as there are transactions
+        return sizeof(Block) + block.getTransactionArena().getByteSize() + transactionCount * sizeof(uint32_t) +
+               2 * transactionCount * HASH_STRING_SIZE + 4 * HASH_STRING_SIZE;
+    }
+
+    BlockCache::Shard& BlockCache::shardFor(const std::string& blockHash) {
+        return *shards_[std::hash<std::string>()(blockHash) % shards_.size()];
+    }
+
+    BlockHandle BlockCache::insert(Block block) {
+        BlockHandle handle = std::make_shared<const Block>(std::move(block));
+        insert(handle);
+        return handle;
+    }
+
+    void BlockCache::insert(const BlockHandle& block) {
+        Entry entry;
+        entry.blockHash = block->getBlockHash();
+        entry.blockHeight = block->getBlockHeight();
+        entry.size = estimateSize(*block);
+        entry.block = block;
+        insertEntry(std::move(entry));
+    }
+
+    void BlockCache::insertEntry(Entry entry) {
+        Shard& shard = shardFor(entry.blockHash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto existing = shard.byHash.find(entry.blockHash);
+        if (existing != shard.byHash.end()) {
+            shard.byteSize -= existing->second->size;
+            shard.lru.erase(existing->second);
+            shard.byHash.erase(existing);
+        }
+
+        {
+            std::lock_guard<std::mutex> heightLock(heightMutex_);
+            byHeight_[entry.blockHeight] = entry.blockHash;
+        }
+
+        shard.byteSize += entry.size;
+        shard.lru.push_front(std::move(entry));
+        shard.byHash[shard.lru.front().blockHash] = shard.lru.begin();
+
+        // Evict from the cold end, but always keep the block just inserted
+        while (shard.byteSize > shardCapacity_ && shard.lru.size() > 1) {
+            Entry& victim = shard.lru.back();
+            shard.byteSize -= victim.size;
+            eraseHeight(victim.blockHeight, victim.blockHash);
+            shard.byHash.erase(victim.blockHash);
+            shard.lru.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void BlockCache::eraseHeight(uint32_t blockHeight, const std::string& blockHash) {
+        std::lock_guard<std::mutex> heightLock(heightMutex_);
+        auto it = byHeight_.find(blockHeight);
+        if (it != byHeight_.end() && it->second == blockHash) {
+            byHeight_.erase(it);
+        }
+    }
+
+    void BlockCache::setTip(const BlockHandle& block) {
+        std::string blockHash = block ? block->getBlockHash() : std::string();
+        if (block) {
+            insert(block);
+        }
+        std::lock_guard<std::mutex> lock(tipMutex_);
+        tip_ = block;
+        tipHash_ = std::move(blockHash);
+    }
+
+    BlockHandle BlockCache::getTip() const {
+        std::lock_guard<std::mutex> lock(tipMutex_);
+        return tip_;
+    }
+
+    BlockHandle BlockCache::tipIfMatches(const std::string& blockHash) const {
+        std::lock_guard<std::mutex> lock(tipMutex_);
+        return tip_ && tipHash_ == blockHash ? tip_ : nullptr;
+    }
+
+    BlockHandle BlockCache::findByHash(const std::string& requestedHash) {
+        const std::string blockHash = normalizeHash(requestedHash);
+        if (BlockHandle tip = tipIfMatches(blockHash)) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return tip;
+        }
+
+        Shard& shard = shardFor(blockHash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.byHash.find(blockHash);
+        if (it == shard.byHash.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second); // Mark as most recently used
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return it->second->block;
+    }
+
+    BlockHandle BlockCache::findByHeight(uint32_t blockHeight) {
+        {
+            std::lock_guard<std::mutex> lock(tipMutex_);
+            if (tip_ && tip_->getBlockHeight() == blockHeight) {
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return tip_;
+            }
+        }
+
+        std::string blockHash;
+        {
+            std::lock_guard<std::mutex> heightLock(heightMutex_);
+            auto it = byHeight_.find(blockHeight);
+            if (it == byHeight_.end()) {
+                misses_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            blockHash = it->second;
+        }
+        return findByHash(blockHash);
+    }
+
+    BlockHandle BlockCache::getByHash(const std::string& blockHash, const std::function<Block()>& loader) {
+        if (BlockHandle block = findByHash(blockHash)) {
+            return block;
+        }
+        Block block = loader();
+        if (block.getBlockHash() != normalizeHash(blockHash)) {
+            throw std::runtime_error("Loaded block " + block.getBlockHash() + " does not have the requested hash " + blockHash);
+        }
+        return insert(std::move(block));
+    }
+
+    BlockHandle BlockCache::loadFromDatabase(const std::string& blockHash, SPHINXDb::DistributedDb& distributedDb) {
+        const std::string key = normalizeHash(blockHash); // Database keys are getBlockHash() values
+        return getByHash(key, [&]() { return Block::loadFromDatabase(key, distributedDb); });
+    }
+
+    BlockHandle BlockCache::load(const BlockStore& blockStore, const std::string& blockHash) {
+        return getByHash(blockHash, [&]() { return Block::load(blockStore, blockHash); });
+    }
+
+    BlockHandle BlockCache::loadByHeight(const BlockStore& blockStore, uint32_t blockHeight) {
+        if (BlockHandle block = findByHeight(blockHeight)) {
+            return block;
+        }
+        return insert(blockStore.loadByHeight(blockHeight));
+    }
+
+    void BlockCache::erase(const std::string& requestedHash) {
+        const std::string blockHash = normalizeHash(requestedHash);
+        {
+            std::lock_guard<std::mutex> lock(tipMutex_);
+            if (tip_ && tipHash_ == blockHash) {
+                tip_.reset();
+                tipHash_.clear();
+            }
+        }
+
+        Shard& shard = shardFor(blockHash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.byHash.find(blockHash);
+        if (it != shard.byHash.end()) {
+            shard.byteSize -= it->second->size;
+            eraseHeight(it->second->blockHeight, blockHash);
+            shard.lru.erase(it->second);
+            shard.byHash.erase(it);
+        }
+    }
+
+    void BlockCache::clear() {
+        {
+            std::lock_guard<std::mutex> lock(tipMutex_);
+            tip_.reset();
+            tipHash_.clear();
+        }
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->lru.clear();
+            shard->byHash.clear();
+            shard->byteSize = 0;
+        }
+        std::lock_guard<std::mutex> heightLock(heightMutex_);
+        byHeight_.clear();
+    }
+
+    BlockCacheStats BlockCache::getStats() const {
+        BlockCacheStats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.evictions = evictions_.load(std::memory_order_relaxed);
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            stats.blockCount += shard->lru.size();
+            stats.byteSize += shard->byteSize;
+        }
+        return stats;
+    }
+} // namespace SPHINXBlock
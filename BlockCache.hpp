@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKCACHE_HPP
+#define SPHINXBLOCKCACHE_HPP
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Block.hpp"
+
+
+namespace SPHINXBlock {
+    class BlockStore; // Forward declaration of the BlockStore class
+
+    // Shared, immutable block handed out by the cache
+    using BlockHandle = std::shared_ptr<const Block>;
+
+    struct BlockCacheOptions {
+        std::size_t maxBytes = std::size_t(256) << 20;  // Memory budget across all shards
+        std::size_t shardCount = 16;                    // Independently locked LRU shards
+    };
+
+    struct BlockCacheStats {
+        uint64_t hits = 0;          // Lookups answered from memory (including the tip)
+        uint64_t misses = 0;        // Lookups that found nothing or went to the loader
+        uint64_t evictions = 0;     // Blocks dropped to stay within maxBytes
+        std::size_t blockCount = 0; // Blocks held by the shards
+        std::size_t byteSize = 0;   // Estimated memory held by the cached blocks
+    };
+
+    // Sharded LRU cache of decoded blocks, indexed by block hash and by height, in front of Block::load and
+    // Block::loadFromDatabase. The chain tip is pinned outside the LRU so it is always served from memory.
+    class BlockCache {
+    public:
+        explicit BlockCache(const BlockCacheOptions& options = BlockCacheOptions());
+
+        BlockCache(const BlockCache&) = delete;
+        BlockCache& operator=(const BlockCache&) = delete;
+
+        // Add a block (replacing any cached block with the same hash) and return its shared handle
+        BlockHandle insert(Block block);
+        void insert(const BlockHandle& block);
+
+        // Pin the block as the chain tip; it is also indexed like any other cached block
+        void setTip(const BlockHandle& block);
+        BlockHandle getTip() const;
+
+        // Memory-only lookups; nullptr when the block is not cached
+        BlockHandle findByHash(const std::string& blockHash);
+        BlockHandle findByHeight(uint32_t blockHeight);
+
+        // Cache-through lookups: on a miss the block is loaded, inserted and returned. Hashes may be in either case;
+        // a loaded block whose hash differs from the requested one throws std::runtime_error and is not cached.
+        BlockHandle getByHash(const std::string& blockHash, const std::function<Block()>& loader);
+        BlockHandle loadFromDatabase(const std::string& blockHash, SPHINXDb::DistributedDb& distributedDb);
+        BlockHandle load(const BlockStore& blockStore, const std::string& blockHash);
+        BlockHandle loadByHeight(const BlockStore& blockStore, uint32_t blockHeight);
+
+        // Drop one block or everything (including the tip)
+        void erase(const std::string& blockHash);
+        void clear();
+
+        BlockCacheStats getStats() const;
+
+        // Approximate heap footprint of a decoded block (header, transactions and cached Merkle levels)
+        static std::size_t estimateSize(const Block& block);
+
+    private:
+        struct Entry {
+            std::string blockHash;
+            uint32_t blockHeight = 0;
+            std::size_t size = 0;
+            BlockHandle block;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::list<Entry> lru;   // Most recently used first
+            std::unordered_map<std::string, std::list<Entry>::iterator> byHash;
+            std::size_t byteSize = 0;
+        };
+
+        Shard& shardFor(const std::string& blockHash);
+        void insertEntry(Entry entry);
+        void eraseHeight(uint32_t blockHeight, const std::string& blockHash);
+        BlockHandle tipIfMatches(const std::string& blockHash) const;
+
+        std::size_t shardCapacity_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+
+        mutable std::mutex heightMutex_;    // Guards byHeight_; only ever taken after a shard mutex, never before
+        std::unordered_map<uint32_t, std::string> byHeight_;
+
+        mutable std::mutex tipMutex_;
+        BlockHandle tip_;
+        std::string tipHash_;
+
+        std::atomic<uint64_t> hits_;
+        std::atomic<uint64_t> misses_;
+        std::atomic<uint64_t> evictions_;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKCACHE_HPP
@@ -0,0 +1,314 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the compact binary block encoding used by Block::save/load and the database functions.
+
+// Layout (version 1, integers little-endian):
+    // magic "SPXB" | version (u8)
+    // previousHash, merkleRoot, signature: tag (u8) | length (u32) | bytes
+    //     tag 0 stores the string as-is, tag 1 stores a lowercase hex string packed into raw bytes
+    // blockHeight (u32) | timestamp (i64) | nonce (u32) | difficulty (u32)
+    // transaction count (u32), then for each transaction: length (u32) | bytes
+
+// BlockReader:
+    // The reader validates every length against the input once, then hands out string_views into the
+    // input for the transactions, so a block can be inspected without copying its payload. Malformed or
+    // truncated input, and hash fields that are not a packed 32-byte digest, throw std::runtime_error.
+
+// readBlockHeader:
+    // Decodes just the header fields into a BlockHeader and stops before the transactions, so index builds and
+    // headers-first sync do not pay for the block body.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "BlockCodec.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        constexpr uint8_t TAG_RAW = 0;
+        constexpr uint8_t TAG_HEX = 1;
+
+        bool isPackableHex(std::string_view value) {
+            if (value.empty() || value.size() % 2 != 0) {
+                return false;
+            }
+            for (char c : value) {
+                if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        uint8_t hexNibble(char c) {
+            return static_cast<uint8_t>(c <= '9' ? c - '0' : c - 'a' + 10);
+        }
+
+        // Bounds-checked cursor over the encoded bytes
+        class Cursor {
+        public:
+            explicit Cursor(std::string_view bytes) : bytes_(bytes), pos_(0) {}
+
+            std::string_view take(std::size_t size) {
+                if (size > bytes_.size() - pos_) {
+                    throw std::runtime_error("Truncated binary block");
+                }
+                std::string_view view = bytes_.substr(pos_, size);
+                pos_ += size;
+                return view;
+            }
+
+            uint8_t readUint8() {
+                return static_cast<uint8_t>(take(1)[0]);
+            }
+
+            uint32_t readUint32() {
+                return static_cast<uint32_t>(readLE(4));
+            }
+
+            int64_t readInt64() {
+                return static_cast<int64_t>(readLE(8));
+            }
+
+            std::size_t position() const {
+                return pos_;
+            }
+
+        private:
+            uint64_t readLE(std::size_t size) {
+                std::string_view view = take(size);
+                uint64_t value = 0;
+                for (std::size_t i = 0; i < size; ++i) {
+                    value |= uint64_t(static_cast<uint8_t>(view[i])) << (8 * i);
+                }
+                return value;
+            }
+
+            std::string_view bytes_;
+            std::size_t pos_;
+        };
+    }
+
+    bool isBinaryBlock(std::string_view bytes) {
+        return bytes.size() >= sizeof(BINARY_MAGIC) && std::memcmp(bytes.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+    }
+
+    BlockHeader readBlockHeader(std::string_view bytes) {
+        if (!isBinaryBlock(bytes)) {
+            throw std::runtime_error("Not a binary block");
+        }
+
+        Cursor cursor(bytes);
+        cursor.take(sizeof(BINARY_MAGIC));
+        const uint8_t version = cursor.readUint8();
+        if (version != BINARY_FORMAT_VERSION) {
+            throw std::runtime_error("Unsupported binary block version: " + std::to_string(version));
+        }
+
+        // A canonical hash is always packed (see BinaryEncoder::writeString), so the field already is the digest
+        auto readDigest = [&cursor]() {
+            const uint8_t tag = cursor.readUint8();
+            const std::string_view field = cursor.take(cursor.readUint32());
+            if (tag != TAG_HEX || field.size() != HASH_FIELD_SIZE) {
+                throw std::runtime_error("Invalid binary block hash field");
+            }
+            Digest digest{};
+            std::memcpy(digest.data(), field.data(), field.size());
+            return digest;
+        };
+
+        BlockHeader header;
+        header.previousHash = readDigest();
+        header.merkleRoot = readDigest();
+        cursor.readUint8();                        // Skip the signature
+        cursor.take(cursor.readUint32());
+        header.blockHeight = cursor.readUint32();
+        header.timestamp = cursor.readInt64();
+        header.nonce = cursor.readUint32();
+        header.difficulty = cursor.readUint32();
+        return header;
+    }
+
+    // BinaryEncoder
+
+    BinaryEncoder::BinaryEncoder(std::string& out) : out_(out) {}
+
+    void BinaryEncoder::writeHeader() {
+        out_.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        out_.push_back(static_cast<char>(BINARY_FORMAT_VERSION));
+    }
+
+    void BinaryEncoder::writeUint32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out_.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    void BinaryEncoder::writeInt64(int64_t value) {
+        const uint64_t bits = static_cast<uint64_t>(value);
+        for (int i = 0; i < 8; ++i) {
+            out_.push_back(static_cast<char>(bits >> (8 * i)));
+        }
+    }
+
+    void BinaryEncoder::writeString(std::string_view value) {
+        if (!isPackableHex(value)) {
+            out_.push_back(static_cast<char>(TAG_RAW));
+            writeBytes(value);
+            return;
+        }
+
+        // Hashes and hex-encoded signatures take half the space as raw bytes
+        out_.push_back(static_cast<char>(TAG_HEX));
+        writeUint32(static_cast<uint32_t>(value.size() / 2));
+        for (std::size_t i = 0; i < value.size(); i += 2) {
+            out_.push_back(static_cast<char>((hexNibble(value[i]) << 4) | hexNibble(value[i + 1])));
+        }
+    }
+
+    void BinaryEncoder::writeBytes(std::string_view value) {
+        if (value.size() > UINT32_MAX) {
+            throw std::length_error("Binary block field exceeds 4 GiB");
+        }
+        writeUint32(static_cast<uint32_t>(value.size()));
+        out_.append(value.data(), value.size());
+    }
+
+    // BlockReader
+
+    BlockReader::BlockReader(std::span<const uint8_t> bytes)
+        : BlockReader(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size())) {}
+
+    BlockReader::BlockReader(std::string_view bytes) {
+        if (!isBinaryBlock(bytes)) {
+            throw std::runtime_error("Not a binary block");
+        }
+
+        Cursor cursor(bytes);
+        cursor.take(sizeof(BINARY_MAGIC));
+        version_ = cursor.readUint8();
+        if (version_ != BINARY_FORMAT_VERSION) {
+            throw std::runtime_error("Unsupported binary block version: " + std::to_string(version_));
+        }
+
+        auto readString = [&cursor]() {
+            StringField field;
+            field.tag = cursor.readUint8();
+            if (field.tag != TAG_RAW && field.tag != TAG_HEX) {
+                throw std::runtime_error("Unknown binary block string tag: " + std::to_string(field.tag));
+            }
+            field.bytes = cursor.take(cursor.readUint32());
+            return field;
+        };
+
+        auto readHash = [&readString]() {
+            const StringField field = readString();
+            if (field.tag != TAG_HEX || field.bytes.size() != HASH_FIELD_SIZE) {
+                throw std::runtime_error("Invalid binary block hash field");
+            }
+            return field;
+        };
+
+        previousHash_ = readHash();
+        merkleRoot_ = readHash();
+        signature_ = readString();
+        blockHeight_ = cursor.readUint32();
+        timestamp_ = cursor.readInt64();
+        nonce_ = cursor.readUint32();
+        difficulty_ = cursor.readUint32();
+
+        const uint32_t transactionCount = cursor.readUint32();
+        // Every transaction needs at least its length prefix, so a bogus count cannot force a huge reserve
+        if (transactionCount > (bytes.size() - cursor.position()) / 4) {
+            throw std::runtime_error("Truncated binary block");
+        }
+        transactions_.reserve(transactionCount);
+        for (uint32_t i = 0; i < transactionCount; ++i) {
+            transactions_.push_back(cursor.take(cursor.readUint32()));
+        }
+
+        encodedSize_ = cursor.position();
+    }
+
+    std::string BlockReader::decodeString(const StringField& field) {
+        if (field.tag == TAG_RAW) {
+            return std::string(field.bytes);
+        }
+
+        static const char* const hexDigits = "0123456789abcdef";
+        std::string value(field.bytes.size() * 2, '0');
+        for (std::size_t i = 0; i < field.bytes.size(); ++i) {
+            const uint8_t byte = static_cast<uint8_t>(field.bytes[i]);
+            value[2 * i] = hexDigits[byte >> 4];
+            value[2 * i + 1] = hexDigits[byte & 0x0f];
+        }
+        return value;
+    }
+
+    uint8_t BlockReader::getVersion() const {
+        return version_;
+    }
+
+    std::string BlockReader::getPreviousHash() const {
+        return decodeString(previousHash_);
+    }
+
+    std::string BlockReader::getMerkleRoot() const {
+        return decodeString(merkleRoot_);
+    }
+
+    std::string BlockReader::getSignature() const {
+        return decodeString(signature_);
+    }
+
+    uint32_t BlockReader::getBlockHeight() const {
+        return blockHeight_;
+    }
+
+    std::time_t BlockReader::getTimestamp() const {
+        return static_cast<std::time_t>(timestamp_);
+    }
+
+    uint32_t BlockReader::getNonce() const {
+        return nonce_;
+    }
+
+    uint32_t BlockReader::getDifficulty() const {
+        return difficulty_;
+    }
+
+    std::size_t BlockReader::getTransactionCount() const {
+        return transactions_.size();
+    }
+
+    std::string_view BlockReader::getTransaction(std::size_t index) const {
+        return transactions_.at(index);
+    }
+
+    const std::vector<std::string_view>& BlockReader::getTransactionViews() const {
+        return transactions_;
+    }
+
+    std::size_t BlockReader::getEncodedSize() const {
+        return encodedSize_;
+    }
+} // namespace SPHINXBlock
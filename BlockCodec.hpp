@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKCODEC_HPP
+#define SPHINXBLOCKCODEC_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BlockHeader.hpp"
+
+
+namespace SPHINXBlock {
+    // Encodings understood by Block::save/load and the database functions
+    enum class BlockFormat {
+        Binary, // Compact, versioned, length-prefixed encoding (default)
+        Json    // Human-readable debug encoding produced by toJson()
+    };
+
+    constexpr char BINARY_MAGIC[4] = {'S', 'P', 'X', 'B'};  // Leading bytes of every binary block
+    constexpr uint8_t BINARY_FORMAT_VERSION = 1;             // Current version of the binary encoding
+
+    // Returns true if the bytes start with the binary block magic
+    bool isBinaryBlock(std::string_view bytes);
+
+    // Decode only the header fields of a binary block, without walking its transactions
+    BlockHeader readBlockHeader(std::string_view bytes);
+
+    // Appends the fields of a binary block to an output buffer
+    class BinaryEncoder {
+    public:
+        explicit BinaryEncoder(std::string& out);
+
+        void writeHeader();                          // Magic and format version
+        void writeUint32(uint32_t value);
+        void writeInt64(int64_t value);
+        void writeString(std::string_view value);    // Tagged, length-prefixed; lowercase hex is packed to raw bytes
+        void writeBytes(std::string_view value);     // Length-prefixed raw bytes
+
+    private:
+        std::string& out_;
+    };
+
+    // Zero-copy reader over an encoded block; string fields and transactions are views into the input bytes
+    class BlockReader {
+    public:
+        explicit BlockReader(std::span<const uint8_t> bytes);
+        explicit BlockReader(std::string_view bytes);
+
+        uint8_t getVersion() const;
+        std::string getPreviousHash() const;
+        std::string getMerkleRoot() const;
+        std::string getSignature() const;
+        uint32_t getBlockHeight() const;
+        std::time_t getTimestamp() const;
+        uint32_t getNonce() const;
+        uint32_t getDifficulty() const;
+
+        std::size_t getTransactionCount() const;
+        std::string_view getTransaction(std::size_t index) const;
+        const std::vector<std::string_view>& getTransactionViews() const;
+
+        // Number of bytes the encoded block occupies in the input
+        std::size_t getEncodedSize() const;
+
+    private:
+        struct StringField {
+            uint8_t tag = 0;
+            std::string_view bytes;
+        };
+
+        static std::string decodeString(const StringField& field);
+
+        uint8_t version_ = 0;
+        StringField previousHash_;
+        StringField merkleRoot_;
+        StringField signature_;
+        uint32_t blockHeight_ = 0;
+        int64_t timestamp_ = 0;
+        uint32_t nonce_ = 0;
+        uint32_t difficulty_ = 0;
+        std::vector<std::string_view> transactions_;
+        std::size_t encodedSize_ = 0;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKCODEC_HPP
@@ -0,0 +1,289 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the optional block compression used by Block::save and Block::saveToDatabase.
+
+// Record layout (integers little-endian):
+    // magic "SPXZ" | codec id (1 byte) | dictionary id (4 bytes) | decoded size (8 bytes) | codec payload
+    // The decoded bytes are an ordinary binary or JSON block, so every existing decoder applies after unwrapping.
+    // Block::deserialize, load and loadFromDatabase recognise the magic and decompress transparently.
+
+// Codecs:
+    // BlockCompressor is the extension point. ZstdCompressor and ZstdDictionaryCompressor are built in (unless
+    // SPHINXBLOCK_NO_ZSTD is defined); custom codecs pick an id of 128 or more and register themselves.
+
+// Dictionaries:
+    // ZstdDictionaryCompressor::train builds a dictionary from recent encoded blocks. Its id is stored in each
+    // record, so a node can keep old dictionaries registered while it writes with a newer one.
+
+// Thread safety:
+    // The registry is guarded by a shared mutex. The zstd compressors keep one compression and one decompression
+    // context per thread, and the digested dictionaries are read-only, so one compressor can serve every thread.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifndef SPHINXBLOCK_NO_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+#include "BlockCompression.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        class CompressorRegistry {
+        public:
+            CompressorRegistry() {
+#ifndef SPHINXBLOCK_NO_ZSTD
+                add(std::make_shared<ZstdCompressor>());
+#endif
+            }
+
+            void add(std::shared_ptr<const BlockCompressor> compressor) {
+                std::unique_lock<std::shared_mutex> lock(mutex_);
+                const uint64_t key = makeKey(compressor->getCodecId(), compressor->getDictionaryId());
+                compressors_[key] = std::move(compressor);
+            }
+
+            std::shared_ptr<const BlockCompressor> find(uint8_t codecId, uint32_t dictionaryId) const {
+                std::shared_lock<std::shared_mutex> lock(mutex_);
+                auto it = compressors_.find(makeKey(codecId, dictionaryId));
+                return it != compressors_.end() ? it->second : nullptr;
+            }
+
+        private:
+            static uint64_t makeKey(uint8_t codecId, uint32_t dictionaryId) {
+                return (static_cast<uint64_t>(codecId) << 32) | dictionaryId;
+            }
+
+            mutable std::shared_mutex mutex_;
+            std::map<uint64_t, std::shared_ptr<const BlockCompressor>> compressors_;
+        };
+
+        CompressorRegistry& registry() {
+            static CompressorRegistry instance;
+            return instance;
+        }
+
+        void appendLittleEndian(std::string& out, uint64_t value, std::size_t byteCount) {
+            for (std::size_t i = 0; i < byteCount; ++i) {
+                out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+            }
+        }
+
+        uint64_t readLittleEndian(std::string_view bytes, std::size_t offset, std::size_t byteCount) {
+            uint64_t value = 0;
+            for (std::size_t i = 0; i < byteCount; ++i) {
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[offset + i])) << (8 * i);
+            }
+            return value;
+        }
+
+#ifndef SPHINXBLOCK_NO_ZSTD
+        struct CCtxDeleter {
+            void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+        };
+        struct DCtxDeleter {
+            void operator()(ZSTD_DCtx* context) const { ZSTD_freeDCtx(context); }
+        };
+
+        // Contexts are reused across calls on the same thread instead of being allocated per block
+        ZSTD_CCtx* threadCompressionContext() {
+            thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> context(ZSTD_createCCtx());
+            return context.get();
+        }
+
+        ZSTD_DCtx* threadDecompressionContext() {
+            thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> context(ZSTD_createDCtx());
+            return context.get();
+        }
+
+        std::string checkedCompress(std::string_view data, const std::function<std::size_t(char*, std::size_t)>& run) {
+            std::string payload(ZSTD_compressBound(data.size()), '\0');
+            const std::size_t written = run(payload.data(), payload.size());
+            if (ZSTD_isError(written)) {
+                throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(written));
+            }
+            payload.resize(written);
+            return payload;
+        }
+
+        std::string checkedDecompress(std::size_t decodedSize, const std::function<std::size_t(char*, std::size_t)>& run) {
+            std::string data(decodedSize, '\0');
+            const std::size_t written = run(data.data(), data.size());
+            if (ZSTD_isError(written)) {
+                throw std::runtime_error(std::string("zstd decompression failed: ") + ZSTD_getErrorName(written));
+            }
+            if (written != decodedSize) {
+                throw std::runtime_error("Compressed block decodes to the wrong size");
+            }
+            return data;
+        }
+#endif
+    }
+
+#ifndef SPHINXBLOCK_NO_ZSTD
+    ZstdCompressor::ZstdCompressor(int level) : level_(level) {
+    }
+
+    uint8_t ZstdCompressor::getCodecId() const {
+        return static_cast<uint8_t>(CompressionCodec::Zstd);
+    }
+
+    std::string ZstdCompressor::compress(std::string_view data) const {
+        return checkedCompress(data, [&](char* out, std::size_t capacity) {
+            return ZSTD_compressCCtx(threadCompressionContext(), out, capacity, data.data(), data.size(), level_);
+        });
+    }
+
+    std::string ZstdCompressor::decompress(std::string_view payload, std::size_t decodedSize) const {
+        return checkedDecompress(decodedSize, [&](char* out, std::size_t capacity) {
+            return ZSTD_decompressDCtx(threadDecompressionContext(), out, capacity, payload.data(), payload.size());
+        });
+    }
+
+    struct ZstdDictionaryCompressor::Dictionaries {
+        ZSTD_CDict* compression = nullptr;
+        ZSTD_DDict* decompression = nullptr;
+
+        ~Dictionaries() {
+            ZSTD_freeCDict(compression);
+            ZSTD_freeDDict(decompression);
+        }
+    };
+
+    ZstdDictionaryCompressor::ZstdDictionaryCompressor(std::string dictionary, int level)
+        : dictionary_(std::move(dictionary)), dictionaryId_(ZDICT_getDictID(dictionary_.data(), dictionary_.size())),
+          dictionaries_(std::make_unique<Dictionaries>()) {
+        if (dictionaryId_ == 0) {
+            throw std::invalid_argument("Not a zstd dictionary (no dictionary id)");
+        }
+        dictionaries_->compression = ZSTD_createCDict(dictionary_.data(), dictionary_.size(), level);
+        dictionaries_->decompression = ZSTD_createDDict(dictionary_.data(), dictionary_.size());
+        if (dictionaries_->compression == nullptr || dictionaries_->decompression == nullptr) {
+            throw std::invalid_argument("Failed to load the zstd dictionary");
+        }
+    }
+
+    ZstdDictionaryCompressor::~ZstdDictionaryCompressor() = default;
+
+    std::string ZstdDictionaryCompressor::train(std::span<const std::string> samples, std::size_t dictionarySize) {
+        std::string buffer;
+        std::vector<std::size_t> sampleSizes;
+        sampleSizes.reserve(samples.size());
+        for (const std::string& sample : samples) {
+            buffer += sample;
+            sampleSizes.push_back(sample.size());
+        }
+
+        std::string dictionary(dictionarySize, '\0');
+        const std::size_t written = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buffer.data(),
+                                                          sampleSizes.data(), static_cast<unsigned int>(sampleSizes.size()));
+        if (ZDICT_isError(written)) {
+            throw std::runtime_error(std::string("zstd dictionary training failed: ") + ZDICT_getErrorName(written));
+        }
+        dictionary.resize(written);
+        return dictionary;
+    }
+
+    uint8_t ZstdDictionaryCompressor::getCodecId() const {
+        return static_cast<uint8_t>(CompressionCodec::ZstdDictionary);
+    }
+
+    uint32_t ZstdDictionaryCompressor::getDictionaryId() const {
+        return dictionaryId_;
+    }
+
+    const std::string& ZstdDictionaryCompressor::getDictionary() const {
+        return dictionary_;
+    }
+
+    std::string ZstdDictionaryCompressor::compress(std::string_view data) const {
+        return checkedCompress(data, [&](char* out, std::size_t capacity) {
+            return ZSTD_compress_usingCDict(threadCompressionContext(), out, capacity, data.data(), data.size(),
+                                            dictionaries_->compression);
+        });
+    }
+
+    std::string ZstdDictionaryCompressor::decompress(std::string_view payload, std::size_t decodedSize) const {
+        return checkedDecompress(decodedSize, [&](char* out, std::size_t capacity) {
+            return ZSTD_decompress_usingDDict(threadDecompressionContext(), out, capacity, payload.data(), payload.size(),
+                                              dictionaries_->decompression);
+        });
+    }
+#endif
+
+    void registerCompressor(std::shared_ptr<const BlockCompressor> compressor) {
+        if (!compressor) {
+            throw std::invalid_argument("registerCompressor: null compressor");
+        }
+        registry().add(std::move(compressor));
+    }
+
+    std::shared_ptr<const BlockCompressor> findCompressor(uint8_t codecId, uint32_t dictionaryId) {
+        return registry().find(codecId, dictionaryId);
+    }
+
+    bool isCompressedBlock(std::string_view bytes) {
+        return bytes.size() >= sizeof(COMPRESSED_MAGIC) &&
+               bytes.compare(0, sizeof(COMPRESSED_MAGIC), std::string_view(COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC))) == 0;
+    }
+
+    std::string compressBlock(std::string_view blockData, const BlockCompressor& compressor) {
+        const std::string payload = compressor.compress(blockData);
+
+        std::string record;
+        record.reserve(COMPRESSED_HEADER_SIZE + payload.size());
+        record.append(COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC));
+        record.push_back(static_cast<char>(compressor.getCodecId()));
+        appendLittleEndian(record, compressor.getDictionaryId(), 4);
+        appendLittleEndian(record, blockData.size(), 8);
+        record += payload;
+        return record;
+    }
+
+    std::string decompressBlock(std::string_view record) {
+        if (!isCompressedBlock(record) || record.size() < COMPRESSED_HEADER_SIZE) {
+            throw std::runtime_error("Truncated compressed block record");
+        }
+
+        const uint8_t codecId = static_cast<uint8_t>(record[4]);
+        const uint32_t dictionaryId = static_cast<uint32_t>(readLittleEndian(record, 5, 4));
+        const uint64_t decodedSize = readLittleEndian(record, 9, 8);
+        if (decodedSize > MAX_DECOMPRESSED_BLOCK_SIZE) {
+            throw std::runtime_error("Compressed block record claims an oversized block");
+        }
+
+        std::shared_ptr<const BlockCompressor> compressor = findCompressor(codecId, dictionaryId);
+        if (!compressor) {
+            throw std::runtime_error("No compressor registered for codec " + std::to_string(codecId) +
+                                     " with dictionary " + std::to_string(dictionaryId));
+        }
+        return compressor->decompress(record.substr(COMPRESSED_HEADER_SIZE), static_cast<std::size_t>(decodedSize));
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKCOMPRESSION_HPP
+#define SPHINXBLOCKCOMPRESSION_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+
+namespace SPHINXBlock {
+    constexpr char COMPRESSED_MAGIC[4] = {'S', 'P', 'X', 'Z'};    // Leading bytes of every compressed block record
+    constexpr std::size_t COMPRESSED_HEADER_SIZE = 17;             // Magic, codec id, dictionary id, decoded size
+    constexpr uint64_t MAX_DECOMPRESSED_BLOCK_SIZE = 1ull << 30;    // Larger decoded sizes are rejected as corrupt
+
+    // Codec ids recorded in compressed block records (custom codecs use 128 and up)
+    enum class CompressionCodec : uint8_t {
+        Zstd = 1,               // Plain zstd
+        ZstdDictionary = 2      // zstd with a dictionary trained on recent blocks
+    };
+
+    // Pluggable block codec. A record names the codec id and dictionary id it was written with, and loads pick
+    // the matching registered compressor.
+    class BlockCompressor {
+    public:
+        virtual ~BlockCompressor() = default;
+
+        virtual uint8_t getCodecId() const = 0;
+        virtual uint32_t getDictionaryId() const { return 0; } // 0 = no dictionary
+
+        virtual std::string compress(std::string_view data) const = 0;
+        // Throws std::runtime_error unless the payload decodes to exactly decodedSize bytes
+        virtual std::string decompress(std::string_view payload, std::size_t decodedSize) const = 0;
+    };
+
+#ifndef SPHINXBLOCK_NO_ZSTD
+    class ZstdCompressor : public BlockCompressor {
+    public:
+        explicit ZstdCompressor(int level = 3);
+
+        uint8_t getCodecId() const override;
+        std::string compress(std::string_view data) const override;
+        std::string decompress(std::string_view payload, std::size_t decodedSize) const override;
+
+    private:
+        int level_;
+    };
+
+    // zstd with a trained dictionary. Hashes, keys and signature prefixes repeat across blocks but rarely within
+    // one, so a dictionary trained on recent blocks compresses far better than plain zstd.
+    class ZstdDictionaryCompressor : public BlockCompressor {
+    public:
+        // Throws std::invalid_argument if the bytes are not a zstd dictionary
+        explicit ZstdDictionaryCompressor(std::string dictionary, int level = 3);
+        ~ZstdDictionaryCompressor() override;
+
+        ZstdDictionaryCompressor(const ZstdDictionaryCompressor&) = delete;
+        ZstdDictionaryCompressor& operator=(const ZstdDictionaryCompressor&) = delete;
+
+        // Train a dictionary of at most dictionarySize bytes on encoded blocks (a few hundred recent blocks is
+        // typical); throws std::runtime_error if zstd cannot train on the samples
+        static std::string train(std::span<const std::string> samples, std::size_t dictionarySize = 112640);
+
+        uint8_t getCodecId() const override;
+        uint32_t getDictionaryId() const override;
+        const std::string& getDictionary() const;
+
+        std::string compress(std::string_view data) const override;
+        std::string decompress(std::string_view payload, std::size_t decodedSize) const override;
+
+    private:
+        struct Dictionaries;
+
+        std::string dictionary_;
+        uint32_t dictionaryId_;
+        std::unique_ptr<Dictionaries> dictionaries_;    // Digested once, shared by every call
+    };
+#endif
+
+    // Make a compressor available to decompressBlock; replaces one with the same codec and dictionary id.
+    // Plain zstd is registered by default.
+    void registerCompressor(std::shared_ptr<const BlockCompressor> compressor);
+    std::shared_ptr<const BlockCompressor> findCompressor(uint8_t codecId, uint32_t dictionaryId);
+
+    // Returns true if the bytes start with the compressed record magic
+    bool isCompressedBlock(std::string_view bytes);
+
+    // Wrap encoded block data in a compressed record
+    std::string compressBlock(std::string_view blockData, const BlockCompressor& compressor);
+
+    // Unwrap a compressed record with the registered compressor it names; throws std::runtime_error if the
+    // record is corrupt or its codec or dictionary is not registered
+    std::string decompressBlock(std::string_view record);
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKCOMPRESSION_HPP
@@ -0,0 +1,249 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the fixed-size binary block header and the midstate hasher used to hash it.
+
+// Header layout:
+    // The header is 84 bytes: previous hash (32), Merkle root (32), height (4), timestamp (8),
+    // difficulty (4) and nonce (4). Hashes are stored as raw digests rather than hex text, and the header
+    // commits to the transactions only through the Merkle root, so its size never depends on block size.
+    // Both hashes must be exactly 64 hex characters, so every header field maps to one string and back.
+
+// Midstate hashing:
+    // The block hash is SPHINX_256(SPHINX_256(prefix) || nonce), where prefix is the first 80 header bytes.
+    // HeaderHasher computes the inner digest once; every mining attempt then hashes a constant 36-byte tail.
+    // hashNonces() hashes a run of nonces through SPHINX_256_xN, so the equal-length tails share SIMD lanes.
+
+// Compact headers:
+    // BlockHeader holds the header fields as raw digests and integers, so it converts to and from the 84-byte
+    // layout without any hex parsing and hashes exactly like the Block it was taken from.
+
+// Hash memo:
+    // Block keeps its hash in a HashMemo, so repeated getBlockHash() calls from indexing and RPC paths hash the
+    // header once. A generation counter keeps a hash computed before an invalidation from being stored after it.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "BlockHeader.hpp"
+#include "Hash.hpp"
+#include "HashBatch.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        int hexValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            return -1; // Uppercase is not canonical: it would decode to a digest that encodes back differently
+        }
+
+        void storeLE(uint8_t* out, uint64_t value, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                out[i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+        }
+
+        uint64_t loadLE(const uint8_t* in, std::size_t size) {
+            uint64_t value = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                value |= uint64_t(in[i]) << (8 * i);
+            }
+            return value;
+        }
+    }
+
+    Digest decodeDigest(const std::string& hexHash) {
+        // An exact length keeps distinct strings from padding out to the same digest
+        if (hexHash.size() != HASH_FIELD_SIZE * 2) {
+            throw std::invalid_argument("Hash is not " + std::to_string(HASH_FIELD_SIZE * 2) + " hex characters: " + hexHash);
+        }
+
+        Digest digest{};
+        for (std::size_t i = 0; i < hexHash.size(); ++i) {
+            const int value = hexValue(hexHash[i]);
+            if (value < 0) {
+                throw std::invalid_argument("Hash is not a lowercase hex string: " + hexHash);
+            }
+            digest[i / 2] |= static_cast<uint8_t>(i % 2 == 0 ? value << 4 : value);
+        }
+        return digest;
+    }
+
+    bool isCanonicalHash(std::string_view hexHash) {
+        return hexHash.size() == HASH_FIELD_SIZE * 2 &&
+               std::all_of(hexHash.begin(), hexHash.end(), [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+    }
+
+    std::string encodeDigest(const Digest& digest) {
+        static const char* const hexDigits = "0123456789abcdef";
+
+        std::string hexHash(HASH_FIELD_SIZE * 2, '0');
+        for (std::size_t i = 0; i < HASH_FIELD_SIZE; ++i) {
+            hexHash[2 * i] = hexDigits[digest[i] >> 4];
+            hexHash[2 * i + 1] = hexDigits[digest[i] & 0x0f];
+        }
+        return hexHash;
+    }
+
+    HeaderBytes encodeHeader(const std::string& previousHash, const std::string& merkleRoot, uint32_t blockHeight,
+                             std::time_t timestamp, uint32_t difficulty, uint32_t nonce) {
+        HeaderBytes header{};
+
+        const Digest previous = decodeDigest(previousHash);
+        const Digest root = decodeDigest(merkleRoot);
+        std::copy(previous.begin(), previous.end(), header.begin() + HEADER_PREV_HASH_OFFSET);
+        std::copy(root.begin(), root.end(), header.begin() + HEADER_MERKLE_ROOT_OFFSET);
+
+        storeLE(header.data() + HEADER_HEIGHT_OFFSET, blockHeight, 4);
+        storeLE(header.data() + HEADER_TIMESTAMP_OFFSET, static_cast<uint64_t>(static_cast<int64_t>(timestamp)), 8);
+        storeLE(header.data() + HEADER_DIFFICULTY_OFFSET, difficulty, 4);
+        storeLE(header.data() + HEADER_NONCE_OFFSET, nonce, 4);
+
+        return header;
+    }
+
+    void setHeaderTimestamp(HeaderBytes& header, std::time_t timestamp) {
+        storeLE(header.data() + HEADER_TIMESTAMP_OFFSET, static_cast<uint64_t>(static_cast<int64_t>(timestamp)), 8);
+    }
+
+    // BlockHeader
+
+    HeaderBytes BlockHeader::toBytes() const {
+        HeaderBytes header{};
+        std::copy(previousHash.begin(), previousHash.end(), header.begin() + HEADER_PREV_HASH_OFFSET);
+        std::copy(merkleRoot.begin(), merkleRoot.end(), header.begin() + HEADER_MERKLE_ROOT_OFFSET);
+        storeLE(header.data() + HEADER_HEIGHT_OFFSET, blockHeight, 4);
+        storeLE(header.data() + HEADER_TIMESTAMP_OFFSET, static_cast<uint64_t>(timestamp), 8);
+        storeLE(header.data() + HEADER_DIFFICULTY_OFFSET, difficulty, 4);
+        storeLE(header.data() + HEADER_NONCE_OFFSET, nonce, 4);
+        return header;
+    }
+
+    BlockHeader BlockHeader::fromBytes(const HeaderBytes& bytes) {
+        BlockHeader header;
+        std::copy_n(bytes.begin() + HEADER_PREV_HASH_OFFSET, HASH_FIELD_SIZE, header.previousHash.begin());
+        std::copy_n(bytes.begin() + HEADER_MERKLE_ROOT_OFFSET, HASH_FIELD_SIZE, header.merkleRoot.begin());
+        header.blockHeight = static_cast<uint32_t>(loadLE(bytes.data() + HEADER_HEIGHT_OFFSET, 4));
+        header.timestamp = static_cast<int64_t>(loadLE(bytes.data() + HEADER_TIMESTAMP_OFFSET, 8));
+        header.difficulty = static_cast<uint32_t>(loadLE(bytes.data() + HEADER_DIFFICULTY_OFFSET, 4));
+        header.nonce = static_cast<uint32_t>(loadLE(bytes.data() + HEADER_NONCE_OFFSET, 4));
+        return header;
+    }
+
+    std::string BlockHeader::calculateHash() const {
+        HeaderHasher hasher(toBytes());
+        return hasher.hashNonce(nonce);
+    }
+
+    std::string BlockHeader::getPreviousHash() const {
+        return encodeDigest(previousHash);
+    }
+
+    std::string BlockHeader::getMerkleRoot() const {
+        return encodeDigest(merkleRoot);
+    }
+
+    // HeaderHasher
+
+    HeaderHasher::HeaderHasher(const HeaderBytes& header) {
+        // Absorb the nonce-independent prefix once
+        const std::string prefix(reinterpret_cast<const char*>(header.data()), HEADER_NONCE_OFFSET);
+        const Digest inner = decodeDigest(SPHINXHash::SPHINX_256(prefix));
+
+        midstate_.assign(reinterpret_cast<const char*>(inner.data()), inner.size());
+        tail_ = midstate_;
+        tail_.append(header.begin() + HEADER_NONCE_OFFSET, header.end());
+    }
+
+    std::string HeaderHasher::hashNonce(uint32_t nonce) {
+        // Only the trailing nonce bytes change between attempts
+        storeLE(reinterpret_cast<uint8_t*>(&tail_[HASH_FIELD_SIZE]), nonce, 4);
+        return SPHINXHash::SPHINX_256(tail_);
+    }
+
+    void HeaderHasher::hashNonces(uint32_t firstNonce, std::size_t count, std::string* blockHashes) {
+        if (batchTails_.size() < count) {
+            batchTails_.resize(count, tail_);
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            storeLE(reinterpret_cast<uint8_t*>(&batchTails_[i][HASH_FIELD_SIZE]), firstNonce + static_cast<uint32_t>(i), 4);
+        }
+        SPHINXHash::SPHINX_256_xN(batchTails_.data(), blockHashes, count);
+    }
+
+    const std::string& HeaderHasher::getMidstate() const {
+        return midstate_;
+    }
+
+    // HashMemo
+
+    HashMemo::HashMemo(const HashMemo& other) {
+        std::lock_guard<std::mutex> lock(other.mutex_);
+        hash_ = other.hash_;
+        valid_ = other.valid_;
+    }
+
+    HashMemo& HashMemo::operator=(const HashMemo& other) {
+        if (this != &other) {
+            std::scoped_lock lock(mutex_, other.mutex_);
+            hash_ = other.hash_;
+            valid_ = other.valid_;
+            ++generation_;
+        }
+        return *this;
+    }
+
+    std::string HashMemo::get(const std::function<std::string()>& compute) const {
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (valid_) {
+                return hash_;
+            }
+            generation = generation_;
+        }
+
+        // Hash outside the lock; concurrent first readers may both compute the same value
+        std::string hash = compute();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation == generation_) {
+            hash_ = hash;
+            valid_ = true;
+        }
+        return hash;
+    }
+
+    void HashMemo::set(const std::string& hash) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hash_ = hash;
+        valid_ = true;
+        ++generation_;
+    }
+
+    void HashMemo::invalidate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        valid_ = false;
+        hash_.clear();
+        ++generation_;
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKHEADER_HPP
+#define SPHINXBLOCKHEADER_HPP
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+namespace SPHINXBlock {
+    // Fixed binary layout of the block header (all integers little-endian)
+    constexpr std::size_t HASH_FIELD_SIZE = 32;            // Size of a binary SPHINX_256 digest
+    constexpr std::size_t HEADER_PREV_HASH_OFFSET = 0;     // previousHash_ as 32 raw bytes
+    constexpr std::size_t HEADER_MERKLE_ROOT_OFFSET = 32;  // merkleRoot_ as 32 raw bytes
+    constexpr std::size_t HEADER_HEIGHT_OFFSET = 64;       // blockHeight_ (uint32)
+    constexpr std::size_t HEADER_TIMESTAMP_OFFSET = 68;    // timestamp_ (int64)
+    constexpr std::size_t HEADER_DIFFICULTY_OFFSET = 76;   // difficulty_ (uint32)
+    constexpr std::size_t HEADER_NONCE_OFFSET = 80;        // nonce_ (uint32), kept last so the prefix is nonce-independent
+    constexpr std::size_t HEADER_SIZE = 84;
+
+    using HeaderBytes = std::array<uint8_t, HEADER_SIZE>;
+    using Digest = std::array<uint8_t, HASH_FIELD_SIZE>;
+
+    // Hash functor for unordered containers keyed by Digest (digests are uniformly distributed already)
+    struct DigestHasher {
+        std::size_t operator()(const Digest& digest) const {
+            std::size_t value;
+            std::memcpy(&value, digest.data(), sizeof(value));
+            return value;
+        }
+    };
+
+    // Convert a canonical hash (64 lowercase hex characters) into a 32-byte digest (throws std::invalid_argument
+    // for anything else, uppercase included, so every accepted string round-trips through encodeDigest)
+    Digest decodeDigest(const std::string& hexHash);
+
+    // Returns true if the string is a hash in canonical form: 64 lowercase hex characters, as encodeDigest writes it
+    bool isCanonicalHash(std::string_view hexHash);
+
+    // Convert a 32-byte digest back into a lowercase hex string
+    std::string encodeDigest(const Digest& digest);
+
+    // Build the binary header committing to the given fields
+    HeaderBytes encodeHeader(const std::string& previousHash, const std::string& merkleRoot, uint32_t blockHeight,
+                             std::time_t timestamp, uint32_t difficulty, uint32_t nonce);
+
+    // Overwrite the timestamp field of an encoded header (used when the miner rolls the timestamp)
+    void setHeaderTimestamp(HeaderBytes& header, std::time_t timestamp);
+
+    // Compact header for light clients and indexes: only the hashed fields, without the transactions, the chain
+    // pointer or the checkpoint list of a Block. Trivially copyable, so headers can be stored back to back.
+    struct BlockHeader {
+        Digest previousHash{};
+        Digest merkleRoot{};
+        int64_t timestamp = 0;
+        uint32_t blockHeight = 0;
+        uint32_t nonce = 0;
+        uint32_t difficulty = 0;
+
+        // Convert to and from the fixed binary layout
+        HeaderBytes toBytes() const;
+        static BlockHeader fromBytes(const HeaderBytes& bytes);
+
+        // Returns the block hash (the same value as Block::calculateBlockHash of the block it came from)
+        std::string calculateHash() const;
+
+        // Hex forms of the hash fields (always 64 characters)
+        std::string getPreviousHash() const;
+        std::string getMerkleRoot() const;
+    };
+
+    static_assert(std::is_trivially_copyable_v<BlockHeader>, "BlockHeader must stay trivially copyable");
+
+    // Midstate header hasher: absorbs the constant header prefix once, then finishes each nonce in constant time
+    class HeaderHasher {
+    public:
+        explicit HeaderHasher(const HeaderBytes& header);
+
+        // Returns the block hash for the header with the given nonce
+        std::string hashNonce(uint32_t nonce);
+
+        // Hash `count` consecutive nonces starting at firstNonce in one batch (see SPHINX_256_xN)
+        void hashNonces(uint32_t firstNonce, std::size_t count, std::string* blockHashes);
+
+        // Returns the binary digest of the nonce-independent prefix
+        const std::string& getMidstate() const;
+
+    private:
+        std::string midstate_;  // SPHINX_256 digest of the header prefix (32 raw bytes)
+        std::string tail_;      // midstate_ followed by the 4 little-endian nonce bytes
+        std::vector<std::string> batchTails_;  // Reused tails for hashNonces
+    };
+
+    // Memoized block hash shared by concurrent const readers; mutators call invalidate() after changing the header
+    class HashMemo {
+    public:
+        HashMemo() = default;
+        HashMemo(const HashMemo& other);
+        HashMemo& operator=(const HashMemo& other);
+
+        // Returns the memoized hash, computing it with `compute` on first use after an invalidation
+        std::string get(const std::function<std::string()>& compute) const;
+
+        // Store a hash that is already known (e.g. the one found by the miner)
+        void set(const std::string& hash);
+
+        void invalidate();
+
+    private:
+        mutable std::mutex mutex_;
+        mutable std::string hash_;
+        mutable bool valid_ = false;
+        uint64_t generation_ = 0;   // Bumped by every invalidation, so a hash computed before one is not stored
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKHEADER_HPP
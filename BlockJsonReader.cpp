@@ -0,0 +1,326 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the streaming reader for JSON blocks used by Block::deserialize, Block::load and Block::loadFromDatabase.
+
+// BlockSaxHandler:
+    // nlohmann::json::sax_parse reports every token of the input to the handler, which keeps only the
+    // top-level block fields and appends each transaction string directly to a TransactionArena. No JSON DOM
+    // is built, so a block is held in memory once (plus the input) instead of three times.
+    // Unknown top-level keys are skipped together with everything nested under them.
+
+// Header-only mode:
+    // The transactions array is not copied. toJson() writes its keys in sorted order, so "transactions" comes
+    // after every header field and the parse stops as soon as the array starts; for other key orders the
+    // array is tokenized but its strings are dropped.
+
+// Chunked input:
+    // A JsonChunkSource is wrapped in a std::streambuf that hands each chunk to the parser as it arrives, so a
+    // block read from the database in pieces is never concatenated into one string.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <cstdint>
+#include <ctime>
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "json.hpp"
+#include "Block.hpp"
+#include "BlockHeader.hpp"
+#include "BlockJsonReader.hpp"
+#include "TransactionArena.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        enum Field : unsigned {
+            FIELD_NONE = 0,
+            FIELD_PREVIOUS_HASH = 1u << 0,
+            FIELD_MERKLE_ROOT = 1u << 1,
+            FIELD_SIGNATURE = 1u << 2,
+            FIELD_BLOCK_HEIGHT = 1u << 3,
+            FIELD_TIMESTAMP = 1u << 4,
+            FIELD_NONCE = 1u << 5,
+            FIELD_DIFFICULTY = 1u << 6,
+            FIELD_TRANSACTIONS = 1u << 7
+        };
+
+        constexpr unsigned HEADER_FIELDS = FIELD_PREVIOUS_HASH | FIELD_MERKLE_ROOT | FIELD_SIGNATURE | FIELD_BLOCK_HEIGHT |
+                                           FIELD_TIMESTAMP | FIELD_NONCE | FIELD_DIFFICULTY;
+
+        Field fieldFromKey(const std::string& key) {
+            if (key == "previousHash") return FIELD_PREVIOUS_HASH;
+            if (key == "merkleRoot") return FIELD_MERKLE_ROOT;
+            if (key == "signature") return FIELD_SIGNATURE;
+            if (key == "blockHeight") return FIELD_BLOCK_HEIGHT;
+            if (key == "timestamp") return FIELD_TIMESTAMP;
+            if (key == "nonce") return FIELD_NONCE;
+            if (key == "difficulty") return FIELD_DIFFICULTY;
+            if (key == "transactions") return FIELD_TRANSACTIONS;
+            return FIELD_NONE;
+        }
+
+        const char* fieldName(unsigned field) {
+            switch (field) {
+                case FIELD_PREVIOUS_HASH: return "previousHash";
+                case FIELD_MERKLE_ROOT: return "merkleRoot";
+                case FIELD_SIGNATURE: return "signature";
+                case FIELD_BLOCK_HEIGHT: return "blockHeight";
+                case FIELD_TIMESTAMP: return "timestamp";
+                case FIELD_NONCE: return "nonce";
+                case FIELD_DIFFICULTY: return "difficulty";
+                default: return "transactions";
+            }
+        }
+
+        // Collects the block fields from the SAX events; depth 1 is the block object, depth 2 the transactions array
+        class BlockSaxHandler final : public nlohmann::json_sax<nlohmann::json> {
+        public:
+            explicit BlockSaxHandler(bool headerOnly) : headerOnly_(headerOnly) {}
+
+            bool null() override { return scalar(); }
+            bool boolean(bool) override { return scalar(); }
+            bool number_integer(number_integer_t value) override { return number(value, true); }
+            bool number_unsigned(number_unsigned_t value) override {
+                return number(static_cast<int64_t>(value), value <= static_cast<number_unsigned_t>(INT64_MAX));
+            }
+            bool number_float(number_float_t, const string_t&) override { return scalar(); } // Block fields are integers
+            bool binary(binary_t&) override { return scalar(); }
+
+            bool string(string_t& value) override {
+                if (inTransactions_ && depth_ == 2) {
+                    if (!headerOnly_) {
+                        transactions_.append(value); // Copy straight into the arena
+                    }
+                    return true;
+                }
+                if (depth_ != 1 || field_ == FIELD_NONE) {
+                    return true;
+                }
+                switch (field_) {
+                    case FIELD_PREVIOUS_HASH: previousHash_ = std::move(value); break;
+                    case FIELD_MERKLE_ROOT: merkleRoot_ = std::move(value); break;
+                    case FIELD_SIGNATURE: signature_ = std::move(value); break;
+                    default: throwTypeError();
+                }
+                seen_ |= field_;
+                return true;
+            }
+
+            bool start_object(std::size_t) override {
+                if (depth_ == 1) {
+                    expectSkipped();
+                } else if (inTransactions_ && depth_ == 2) {
+                    throw std::runtime_error("Malformed JSON block: transactions must be strings");
+                }
+                ++depth_;
+                return true;
+            }
+
+            bool key(string_t& value) override {
+                if (depth_ == 1) {
+                    field_ = fieldFromKey(value);
+                    if (field_ != FIELD_NONE && (seen_ & field_)) {
+                        throw std::runtime_error(std::string("Malformed JSON block: duplicate field ") + fieldName(field_));
+                    }
+                }
+                return true;
+            }
+
+            bool end_object() override {
+                --depth_;
+                return true;
+            }
+
+            bool start_array(std::size_t) override {
+                if (depth_ == 0) {
+                    throw std::runtime_error("Malformed JSON block: expected an object");
+                }
+                if (depth_ == 1 && field_ == FIELD_TRANSACTIONS) {
+                    if (headerOnly_ && (seen_ & HEADER_FIELDS) == HEADER_FIELDS) {
+                        stoppedEarly_ = true;
+                        return false; // Everything a header-only caller needs has been read
+                    }
+                    inTransactions_ = true;
+                } else if (depth_ == 1) {
+                    expectSkipped();
+                } else if (inTransactions_ && depth_ == 2) {
+                    throw std::runtime_error("Malformed JSON block: transactions must be strings");
+                }
+                ++depth_;
+                return true;
+            }
+
+            bool end_array() override {
+                if (--depth_ == 1 && inTransactions_) {
+                    inTransactions_ = false;
+                    seen_ |= FIELD_TRANSACTIONS;
+                }
+                return true;
+            }
+
+            bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+                throw std::runtime_error(std::string("Malformed JSON block: ") + ex.what());
+            }
+
+            // Check the parse result and move the fields into the block
+            void apply(bool parsed, Block& block) {
+                if (!parsed && !stoppedEarly_) {
+                    throw std::runtime_error("Malformed JSON block");
+                }
+                const unsigned required = headerOnly_ ? HEADER_FIELDS : HEADER_FIELDS | FIELD_TRANSACTIONS;
+                for (unsigned field = 1; field <= FIELD_TRANSACTIONS; field <<= 1) {
+                    if ((required & field) && !(seen_ & field)) {
+                        throw std::runtime_error(std::string("JSON block is missing field: ") + fieldName(field));
+                    }
+                }
+
+                if (!isCanonicalHash(previousHash_) || !isCanonicalHash(merkleRoot_)) {
+                    throw std::runtime_error("Malformed JSON block: previousHash and merkleRoot must be 64-character lowercase hex hashes");
+                }
+
+                block.setPreviousHash(previousHash_);
+                block.setMerkleRoot(merkleRoot_);
+                block.setSignature(signature_);
+                block.setBlockHeight(blockHeight_);
+                block.setTimestamp(timestamp_);
+                block.setNonce(nonce_);
+                block.setDifficulty(difficulty_);
+                block.setTransactions(std::move(transactions_));
+            }
+
+        private:
+            // fitsInt64 is false for unsigned values above INT64_MAX, which no field can hold
+            bool number(int64_t value, bool fitsInt64) {
+                if (inTransactions_ && depth_ == 2) {
+                    throw std::runtime_error("Malformed JSON block: transactions must be strings");
+                }
+                if (depth_ != 1 || field_ == FIELD_NONE) {
+                    return true;
+                }
+                switch (field_) {
+                    case FIELD_BLOCK_HEIGHT: blockHeight_ = uint32Field(value, fitsInt64); break;
+                    case FIELD_TIMESTAMP:
+                        if (!fitsInt64) {
+                            throwRangeError();
+                        }
+                        timestamp_ = static_cast<std::time_t>(value);
+                        break;
+                    case FIELD_NONCE: nonce_ = uint32Field(value, fitsInt64); break;
+                    case FIELD_DIFFICULTY: difficulty_ = uint32Field(value, fitsInt64); break;
+                    default: throwTypeError();
+                }
+                seen_ |= field_;
+                return true;
+            }
+
+            uint32_t uint32Field(int64_t value, bool fitsInt64) const {
+                if (!fitsInt64 || value < 0 || value > static_cast<int64_t>(UINT32_MAX)) {
+                    throwRangeError();
+                }
+                return static_cast<uint32_t>(value);
+            }
+
+            bool scalar() {
+                if (inTransactions_ && depth_ == 2) {
+                    throw std::runtime_error("Malformed JSON block: transactions must be strings");
+                }
+                if (depth_ == 1) {
+                    expectSkipped();
+                }
+                return true;
+            }
+
+            // Only unknown keys may hold values of an unexpected type
+            void expectSkipped() const {
+                if (field_ != FIELD_NONE) {
+                    throwTypeError();
+                }
+            }
+
+            [[noreturn]] void throwTypeError() const {
+                throw std::runtime_error(std::string("Malformed JSON block: unexpected type for field ") + fieldName(field_));
+            }
+
+            [[noreturn]] void throwRangeError() const {
+                throw std::runtime_error(std::string("Malformed JSON block: value out of range for field ") + fieldName(field_));
+            }
+
+            bool headerOnly_;
+            bool inTransactions_ = false;
+            bool stoppedEarly_ = false;
+            std::size_t depth_ = 0;
+            Field field_ = FIELD_NONE;
+            unsigned seen_ = 0;
+
+            std::string previousHash_;
+            std::string merkleRoot_;
+            std::string signature_;
+            uint32_t blockHeight_ = 0;
+            std::time_t timestamp_ = 0;
+            uint32_t nonce_ = 0;
+            uint32_t difficulty_ = 0;
+            TransactionArena transactions_;
+        };
+
+        // Presents the chunks of a JsonChunkSource as one input stream without copying them
+        class ChunkStreamBuf final : public std::streambuf {
+        public:
+            explicit ChunkStreamBuf(const JsonChunkSource& source) : source_(source) {}
+
+        protected:
+            int_type underflow() override {
+                if (done_) {
+                    return traits_type::eof();
+                }
+                const std::string_view chunk = source_();
+                if (chunk.empty()) {
+                    done_ = true; // An empty chunk ends the input
+                    return traits_type::eof();
+                }
+                char* begin = const_cast<char*>(chunk.data()); // The get area is never written through
+                setg(begin, begin, begin + chunk.size());
+                return traits_type::to_int_type(*begin);
+            }
+
+        private:
+            const JsonChunkSource& source_;
+            bool done_ = false;
+        };
+    }
+
+    void readJsonBlock(std::string_view blockJson, Block& block, bool headerOnly) {
+        BlockSaxHandler handler(headerOnly);
+        const bool parsed = nlohmann::json::sax_parse(blockJson.begin(), blockJson.end(), &handler);
+        handler.apply(parsed, block);
+    }
+
+    void readJsonBlock(std::istream& input, Block& block, bool headerOnly) {
+        BlockSaxHandler handler(headerOnly);
+        const bool parsed = nlohmann::json::sax_parse(input, &handler);
+        handler.apply(parsed, block);
+    }
+
+    void readJsonBlock(const JsonChunkSource& source, Block& block, bool headerOnly) {
+        ChunkStreamBuf buffer(source);
+        std::istream input(&buffer);
+        readJsonBlock(input, block, headerOnly);
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKJSONREADER_HPP
+#define SPHINXBLOCKJSONREADER_HPP
+
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <string_view>
+
+
+namespace SPHINXBlock {
+    class Block; // Forward declaration of the Block class
+
+    // Supplies a JSON block piece by piece; each call returns the next chunk (valid until the following call), empty at the end
+    using JsonChunkSource = std::function<std::string_view()>;
+
+    // Streaming (SAX) readers for JSON blocks: the fields go straight into the Block without building a JSON DOM.
+    // In header-only mode the transactions array is skipped and the block is left without transactions.
+    // Malformed input or a missing header field throws std::runtime_error; the block is only modified on success.
+    void readJsonBlock(std::string_view blockJson, Block& block, bool headerOnly = false);
+    void readJsonBlock(std::istream& input, Block& block, bool headerOnly = false);
+    void readJsonBlock(const JsonChunkSource& source, Block& block, bool headerOnly = false);
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKJSONREADER_HPP
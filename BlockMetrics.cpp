@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the hot-path instrumentation of the Block operations (see BlockMetrics.hpp).
+
+// Recording:
+    // Every thread that records a call gets its own slot of atomic counters on first use. Only the owning
+    // thread writes a slot, so recordBlockOp is a handful of relaxed loads and stores: no locks, no shared
+    // cache lines and no read-modify-write instructions. When a thread exits, its totals are folded into a
+    // retired slot and the slot is released.
+
+// Aggregation:
+    // getMetricsSnapshot sums the live slots with relaxed loads while the writers keep going; the registry
+    // mutex is only held against threads starting or exiting, never by the recording path. resetMetrics is
+    // best effort: a call finishing at the same moment may survive the reset.
+
+// Export:
+    // toPrometheus writes a calls_total counter and a duration histogram (cumulative buckets, in seconds) per
+    // operation; toJson writes the same data with the non-cumulative microsecond buckets.
+
+// Building with SPHINXBLOCK_NO_METRICS turns SPHINXBLOCK_TIME_OP into nothing, so the Block functions carry no
+// timing code at all; the snapshot functions still exist and report zeros.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BlockMetrics.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        struct AtomicOpMetrics {
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> totalNanoseconds{0};
+            std::array<std::atomic<uint64_t>, LATENCY_BUCKET_COUNT> buckets{};
+        };
+
+        struct ThreadSlot {
+            std::array<AtomicOpMetrics, BLOCK_OP_COUNT> ops;
+        };
+
+        // Add a relaxed atomic owned by the calling thread (no other thread writes it)
+        void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        void addSlot(MetricsSnapshot& snapshot, const ThreadSlot& slot) {
+            for (std::size_t op = 0; op < BLOCK_OP_COUNT; ++op) {
+                OpMetrics& total = snapshot.ops[op];
+                const AtomicOpMetrics& source = slot.ops[op];
+                total.count += source.count.load(std::memory_order_relaxed);
+                total.totalNanoseconds += source.totalNanoseconds.load(std::memory_order_relaxed);
+                for (std::size_t bucket = 0; bucket < LATENCY_BUCKET_COUNT; ++bucket) {
+                    total.buckets[bucket] += source.buckets[bucket].load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        class Registry {
+        public:
+            void add(ThreadSlot* slot) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                slots_.push_back(slot);
+            }
+
+            void retire(ThreadSlot* slot) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                addSlot(retired_, *slot);
+                slots_.erase(std::remove(slots_.begin(), slots_.end(), slot), slots_.end());
+            }
+
+            MetricsSnapshot snapshot() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                MetricsSnapshot snapshot = retired_;
+                for (const ThreadSlot* slot : slots_) {
+                    addSlot(snapshot, *slot);
+                }
+                return snapshot;
+            }
+
+            void reset() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                retired_ = MetricsSnapshot();
+                for (ThreadSlot* slot : slots_) {
+                    for (AtomicOpMetrics& op : slot->ops) {
+                        op.count.store(0, std::memory_order_relaxed);
+                        op.totalNanoseconds.store(0, std::memory_order_relaxed);
+                        for (std::atomic<uint64_t>& bucket : op.buckets) {
+                            bucket.store(0, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            }
+
+        private:
+            std::mutex mutex_;
+            std::vector<ThreadSlot*> slots_;
+            MetricsSnapshot retired_;   // Totals of threads that have exited
+        };
+
+        Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        // Registers the calling thread's slot on first use and folds it into the retired totals on thread exit
+        class SlotHandle {
+        public:
+            SlotHandle() : registry_(registry()) { registry_.add(&slot_); }
+            ~SlotHandle() { registry_.retire(&slot_); }
+
+            ThreadSlot& get() { return slot_; }
+
+        private:
+            Registry& registry_;
+            ThreadSlot slot_;
+        };
+
+        ThreadSlot& threadSlot() {
+            thread_local SlotHandle handle;
+            return handle.get();
+        }
+
+        // First bucket whose upper bound the latency does not exceed (le semantics, as Prometheus labels them)
+        std::size_t bucketIndex(std::chrono::nanoseconds latency) {
+            const uint64_t nanoseconds = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+            const uint64_t microseconds = (nanoseconds + 999) / 1000;   // Rounded up so 1.5 us is not counted as <= 1 us
+            const std::size_t bucket = microseconds <= 1 ? 0 : static_cast<std::size_t>(std::bit_width(microseconds - 1));
+            return std::min<std::size_t>(bucket, LATENCY_BUCKET_COUNT - 1);
+        }
+
+        // Upper bound of a bucket in microseconds (the last bucket has none)
+        uint64_t bucketUpperBound(std::size_t bucket) {
+            return uint64_t(1) << bucket;
+        }
+
+        const char* const OP_NAMES[BLOCK_OP_COUNT] = {
+            "calculate_block_hash",
+            "calculate_merkle_root",
+            "sign_merkle_root",
+            "verify_block",
+            "mine_block",
+            "save",
+            "load",
+            "save_to_database",
+            "load_from_database",
+        };
+    }
+
+    const char* getBlockOpName(BlockOp op) {
+        const std::size_t index = static_cast<std::size_t>(op);
+        return index < BLOCK_OP_COUNT ? OP_NAMES[index] : "unknown";
+    }
+
+    void recordBlockOp(BlockOp op, std::chrono::nanoseconds latency) {
+        if constexpr (METRICS_ENABLED) {
+            AtomicOpMetrics& metrics = threadSlot().ops[static_cast<std::size_t>(op)];
+            bump(metrics.count, 1);
+            bump(metrics.totalNanoseconds, static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0)));
+            bump(metrics.buckets[bucketIndex(latency)], 1);
+        }
+    }
+
+    MetricsSnapshot getMetricsSnapshot() {
+        return registry().snapshot();
+    }
+
+    void resetMetrics() {
+        registry().reset();
+    }
+
+    std::string toPrometheus(const MetricsSnapshot& snapshot) {
+        std::ostringstream out;
+
+        out << "# HELP sphinxblock_op_calls_total Completed Block operations.\n";
+        out << "# TYPE sphinxblock_op_calls_total counter\n";
+        for (std::size_t op = 0; op < BLOCK_OP_COUNT; ++op) {
+            out << "sphinxblock_op_calls_total{op=\"" << OP_NAMES[op] << "\"} " << snapshot.ops[op].count << '\n';
+        }
+
+        out << "# HELP sphinxblock_op_duration_seconds Latency of Block operations.\n";
+        out << "# TYPE sphinxblock_op_duration_seconds histogram\n";
+        for (std::size_t op = 0; op < BLOCK_OP_COUNT; ++op) {
+            const OpMetrics& metrics = snapshot.ops[op];
+            uint64_t cumulative = 0;
+            for (std::size_t bucket = 0; bucket + 1 < LATENCY_BUCKET_COUNT; ++bucket) {
+                cumulative += metrics.buckets[bucket];
+                out << "sphinxblock_op_duration_seconds_bucket{op=\"" << OP_NAMES[op] << "\",le=\""
+                    << static_cast<double>(bucketUpperBound(bucket)) / 1e6 << "\"} " << cumulative << '\n';
+            }
+            out << "sphinxblock_op_duration_seconds_bucket{op=\"" << OP_NAMES[op] << "\",le=\"+Inf\"} " << metrics.count << '\n';
+            out << "sphinxblock_op_duration_seconds_sum{op=\"" << OP_NAMES[op] << "\"} " << static_cast<double>(metrics.totalNanoseconds) / 1e9 << '\n';
+            out << "sphinxblock_op_duration_seconds_count{op=\"" << OP_NAMES[op] << "\"} " << metrics.count << '\n';
+        }
+        return out.str();
+    }
+
+    nlohmann::json toJson(const MetricsSnapshot& snapshot) {
+        nlohmann::json upperBounds = nlohmann::json::array();
+        for (std::size_t bucket = 0; bucket + 1 < LATENCY_BUCKET_COUNT; ++bucket) {
+            upperBounds.push_back(bucketUpperBound(bucket));
+        }
+
+        nlohmann::json ops = nlohmann::json::object();
+        for (std::size_t op = 0; op < BLOCK_OP_COUNT; ++op) {
+            const OpMetrics& metrics = snapshot.ops[op];
+            ops[OP_NAMES[op]] = {
+                {"count", metrics.count},
+                {"totalNanoseconds", metrics.totalNanoseconds},
+                {"buckets", metrics.buckets}
+            };
+        }
+
+        return {
+            {"enabled", METRICS_ENABLED},
+            {"bucketUpperBoundsMicroseconds", upperBounds},  // The last bucket in "buckets" is unbounded
+            {"ops", ops}
+        };
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKMETRICS_HPP
+#define SPHINXBLOCKMETRICS_HPP
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "json.hpp"
+
+
+namespace SPHINXBlock {
+    // Block operations with a counter and a latency histogram
+    enum class BlockOp {
+        CalculateBlockHash,
+        CalculateMerkleRoot,
+        SignMerkleRoot,
+        VerifyBlock,
+        MineBlock,
+        Save,
+        Load,
+        SaveToDatabase,
+        LoadFromDatabase,
+        Count   // Number of operations, not an operation
+    };
+
+    constexpr std::size_t BLOCK_OP_COUNT = static_cast<std::size_t>(BlockOp::Count);
+
+    // Latency buckets: bucket i counts calls that took at most 2^i microseconds and more than the bound of the
+    // bucket below it, the last one everything slower
+    constexpr std::size_t LATENCY_BUCKET_COUNT = 24;
+
+#ifdef SPHINXBLOCK_NO_METRICS
+    constexpr bool METRICS_ENABLED = false;
+#else
+    constexpr bool METRICS_ENABLED = true;
+#endif
+
+    struct OpMetrics {
+        uint64_t count = 0;                                         // Completed calls
+        uint64_t totalNanoseconds = 0;                              // Sum of their latencies
+        std::array<uint64_t, LATENCY_BUCKET_COUNT> buckets = {};    // Latency histogram (non-cumulative)
+    };
+
+    // Totals over every thread at the time of the snapshot
+    struct MetricsSnapshot {
+        std::array<OpMetrics, BLOCK_OP_COUNT> ops = {};
+    };
+
+    // Returns the snake_case name used in the exported metrics (e.g. "calculate_block_hash")
+    const char* getBlockOpName(BlockOp op);
+
+    // Record one call; each thread writes only its own slot, so this never takes a lock
+    void recordBlockOp(BlockOp op, std::chrono::nanoseconds latency);
+
+    // Sum the per-thread slots (and the totals of exited threads) without stopping the writers
+    MetricsSnapshot getMetricsSnapshot();
+
+    // Zero every counter, e.g. between benchmark runs
+    void resetMetrics();
+
+    // Export a snapshot as Prometheus text exposition format or as JSON
+    std::string toPrometheus(const MetricsSnapshot& snapshot);
+    nlohmann::json toJson(const MetricsSnapshot& snapshot);
+
+    // Times the enclosing scope and records it on exit
+    class ScopedOpTimer {
+    public:
+        explicit ScopedOpTimer(BlockOp op) : op_(op), start_(std::chrono::steady_clock::now()) {}
+        ~ScopedOpTimer() { recordBlockOp(op_, std::chrono::steady_clock::now() - start_); }
+
+        ScopedOpTimer(const ScopedOpTimer&) = delete;
+        ScopedOpTimer& operator=(const ScopedOpTimer&) = delete;
+
+    private:
+        BlockOp op_;
+        std::chrono::steady_clock::time_point start_;
+    };
+} // namespace SPHINXBlock
+
+// Time the rest of the enclosing scope as the given BlockOp; expands to nothing with SPHINXBLOCK_NO_METRICS
+#ifdef SPHINXBLOCK_NO_METRICS
+#define SPHINXBLOCK_TIME_OP(op) ((void)0)
+#else
+#define SPHINXBLOCK_TIME_OP_CONCAT2(a, b) a##b
+#define SPHINXBLOCK_TIME_OP_CONCAT(a, b) SPHINXBLOCK_TIME_OP_CONCAT2(a, b)
+#define SPHINXBLOCK_TIME_OP(op) ::SPHINXBlock::ScopedOpTimer SPHINXBLOCK_TIME_OP_CONCAT(sphinxOpTimer_, __LINE__)(::SPHINXBlock::BlockOp::op)
+#endif
+
+#endif // SPHINXBLOCKMETRICS_HPP
@@ -0,0 +1,319 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the BlockPipeline class, the staged form of block validation used during sync.
+
+// Stages:
+    // parse: decodes the block data with Block::deserialize (which also rebuilds the Merkle tree), on parseThreads workers.
+    //     With headerValidation set, binary blocks first have their header read on its own (readBlockHeader) and
+    //     checked (checkHeader), so a block with a bad timestamp, difficulty or proof of work is never decoded.
+    //     checkHeader sees each header without its parent: previousHash and height linkage are not checked here
+    //     (run validateHeaders over the header chain for that).
+    // hash: computes the memoized block hash, checks the stored Merkle root against the tree and checks the block
+    //     against the checkpoints (if any), on one thread.
+    // signature: checks the SPHINCS+ signature over the block hash, on signatureThreads workers. With checkpoints and
+    //     a headerChain, blocks on the header chain leading to the last checkpoint are assumed valid and pass
+    //     straight through (fast initial sync); a block at a covered height but off that chain is still checked.
+    // connect: applies valid blocks through the connect function (SPHINXUtxo::updateUTXOSet by default), on one thread.
+
+// Queues:
+    // Stages are joined by BoundedQueues of queueCapacity blocks, so a fast stage blocks instead of buffering
+    // the whole chain in memory, and block N+1 is decoded and hashed while block N's signature is checked.
+    // The last worker of a multi-threaded stage closes the next queue, which lets the shutdown ripple through.
+
+// Ordering:
+    // The parse and signature stages finish blocks out of order. The connect stage holds early arrivals until
+    // every lower sequence number has arrived, so UTXO updates are applied strictly in submission order.
+
+// Exceptions:
+    // Every stage runs its per-job work under try/catch. A decode or check that throws marks that block
+    // Malformed (with the message in PipelineResult::error) instead of escaping the worker thread.
+
+// Invalid blocks:
+    // With stopOnInvalid the lowest invalid sequence number is shared with every stage; blocks after it are
+    // passed along without any decoding, hashing or signature work and reported as Skipped.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "BlockPipeline.hpp"
+#include "Block.hpp"
+#include "BlockCodec.hpp"
+#include "CheckpointIndex.hpp"
+#include "HeaderIndex.hpp"
+#include "HeaderValidator.hpp"
+#include "Utxo.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        constexpr uint64_t NO_INVALID_BLOCK = UINT64_MAX;
+
+        unsigned int resolveThreadCount(unsigned int threadCount) {
+            return threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    BlockPipeline::BlockPipeline(const SPHINXMerkleBlock::SPHINXPubKey& publicKey, ConnectFunction connect,
+                                 const BlockPipelineOptions& options)
+        : publicKey_(publicKey), connect_(std::move(connect)), options_(options),
+          parseQueue_(options.queueCapacity), hashQueue_(options.queueCapacity),
+          signatureQueue_(options.queueCapacity), connectQueue_(options.queueCapacity),
+          parseWorkers_(0), signatureWorkers_(0), firstInvalid_(NO_INVALID_BLOCK),
+          submitted_(0), finished_(false) {
+        if (options_.checkpoints != nullptr && options_.headerChain != nullptr) {
+            assumedValid_ = options_.checkpoints->getAssumedValidChain(*options_.headerChain);
+        }
+        start();
+    }
+
+    BlockPipeline::BlockPipeline(const SPHINXMerkleBlock::SPHINXPubKey& publicKey, std::map<std::string, SPHINXUtxo::UTXO>& utxoSet,
+                                 const BlockPipelineOptions& options)
+        : BlockPipeline(publicKey, [&utxoSet](const Block& block) { SPHINXUtxo::updateUTXOSet(block, utxoSet); }, options) {
+    }
+
+    BlockPipeline::~BlockPipeline() {
+        try {
+            finish();
+        } catch (...) {
+            // A connect failure was not collected by the caller; the threads are joined either way
+        }
+    }
+
+    void BlockPipeline::start() {
+        options_.parseThreads = resolveThreadCount(options_.parseThreads);
+        options_.signatureThreads = resolveThreadCount(options_.signatureThreads);
+        parseWorkers_ = options_.parseThreads;
+        signatureWorkers_ = options_.signatureThreads;
+
+        threads_.reserve(options_.parseThreads + options_.signatureThreads + 2);
+        for (unsigned int i = 0; i < options_.parseThreads; ++i) {
+            threads_.emplace_back(&BlockPipeline::parseLoop, this);
+        }
+        threads_.emplace_back(&BlockPipeline::hashLoop, this);
+        for (unsigned int i = 0; i < options_.signatureThreads; ++i) {
+            threads_.emplace_back(&BlockPipeline::signatureLoop, this);
+        }
+        threads_.emplace_back(&BlockPipeline::connectLoop, this);
+    }
+
+    uint64_t BlockPipeline::submit(std::string blockData) {
+        std::lock_guard<std::mutex> lock(submitMutex_);
+        if (finished_) {
+            throw std::logic_error("BlockPipeline::submit called after finish()");
+        }
+
+        auto job = std::make_unique<Job>();
+        job->sequence = submitted_++;
+        job->blockData = std::move(blockData);
+        const uint64_t sequence = job->sequence;
+        parseQueue_.push(std::move(job)); // Keeps submissions in sequence order while it waits for room
+        return sequence;
+    }
+
+    uint64_t BlockPipeline::submit(Block block) {
+        std::lock_guard<std::mutex> lock(submitMutex_);
+        if (finished_) {
+            throw std::logic_error("BlockPipeline::submit called after finish()");
+        }
+
+        auto job = std::make_unique<Job>();
+        job->sequence = submitted_++;
+        job->block = std::make_unique<Block>(std::move(block)); // Already decoded; the parse stage passes it on
+        const uint64_t sequence = job->sequence;
+        parseQueue_.push(std::move(job));
+        return sequence;
+    }
+
+    std::vector<PipelineResult> BlockPipeline::finish() {
+        {
+            std::lock_guard<std::mutex> lock(submitMutex_);
+            if (!finished_) {
+                finished_ = true;
+                parseQueue_.close();
+            }
+        }
+
+        for (std::thread& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+
+        if (connectError_) {
+            std::exception_ptr error = std::exchange(connectError_, nullptr);
+            std::rethrow_exception(error);
+        }
+        return std::move(results_);
+    }
+
+    void BlockPipeline::markInvalid(Job& job, PipelineStatus status) {
+        job.failed = true;
+        job.result.status = status;
+
+        uint64_t current = firstInvalid_.load(std::memory_order_relaxed);
+        while (job.sequence < current && !firstInvalid_.compare_exchange_weak(current, job.sequence, std::memory_order_relaxed)) {
+        }
+    }
+
+    void BlockPipeline::markMalformed(Job& job) {
+        try {
+            throw;
+        } catch (const std::exception& e) {
+            job.result.error = e.what();
+        } catch (...) {
+            job.result.error = "Unknown exception";
+        }
+        markInvalid(job, PipelineStatus::Malformed);
+    }
+
+    bool BlockPipeline::isPastInvalid(uint64_t sequence) const {
+        return options_.stopOnInvalid && sequence > firstInvalid_.load(std::memory_order_relaxed);
+    }
+
+    void BlockPipeline::preValidateHeader(Job& job) {
+        std::optional<BlockHeader> header;
+        if (job.block) {
+            header = job.block->getHeader();
+        } else if (isBinaryBlock(job.blockData)) {
+            try {
+                header = readBlockHeader(job.blockData);
+            } catch (const std::exception&) {
+                return; // Reported as Malformed by the full decode
+            }
+        }
+        if (!header) {
+            return; // JSON blocks are checked by the later stages only
+        }
+
+        job.result.headerStatus = checkHeader(*header, *options_.headerValidation);
+        if (job.result.headerStatus != HeaderStatus::Valid) {
+            markInvalid(job, PipelineStatus::InvalidHeader);
+        }
+    }
+
+    void BlockPipeline::parseLoop() {
+        while (std::optional<JobPtr> next = parseQueue_.pop()) {
+            Job& job = **next;
+            try {
+                if (options_.headerValidation != nullptr && !isPastInvalid(job.sequence)) {
+                    preValidateHeader(job);
+                }
+                if (!job.failed && !job.block && !isPastInvalid(job.sequence)) {
+                    job.block = std::make_unique<Block>(Block::deserialize(job.blockData));
+                }
+            } catch (...) {
+                markMalformed(job);
+            }
+            std::string().swap(job.blockData); // The decoded block holds its own copy from here on
+            hashQueue_.push(std::move(*next));
+        }
+
+        if (parseWorkers_.fetch_sub(1) == 1) {
+            hashQueue_.close();
+        }
+    }
+
+    void BlockPipeline::hashLoop() {
+        while (std::optional<JobPtr> next = hashQueue_.pop()) {
+            Job& job = **next;
+            try {
+                if (!job.failed && job.block && !isPastInvalid(job.sequence)) {
+                    job.result.blockHash = job.block->getBlockHash(); // Memoized for the signature check
+                    if (!job.block->verifyMerkleRoot(publicKey_)) {
+                        markInvalid(job, PipelineStatus::InvalidMerkleRoot);
+                    } else if (options_.checkpoints != nullptr) {
+                        if (!options_.checkpoints->matches(job.block->getBlockHeight(), job.result.blockHash)) {
+                            markInvalid(job, PipelineStatus::InvalidCheckpoint);
+                        } else {
+                            job.assumeValid = !assumedValid_.empty() && assumedValid_.count(decodeDigest(job.result.blockHash)) != 0;
+                        }
+                    }
+                }
+            } catch (...) {
+                markMalformed(job);
+            }
+            signatureQueue_.push(std::move(*next));
+        }
+        signatureQueue_.close();
+    }
+
+    void BlockPipeline::signatureLoop() {
+        while (std::optional<JobPtr> next = signatureQueue_.pop()) {
+            Job& job = **next;
+            try {
+                if (!job.failed && !job.assumeValid && job.block && !isPastInvalid(job.sequence) && !job.block->verifySignature(publicKey_)) {
+                    markInvalid(job, PipelineStatus::InvalidSignature);
+                }
+            } catch (...) {
+                markMalformed(job);
+            }
+            connectQueue_.push(std::move(*next));
+        }
+
+        if (signatureWorkers_.fetch_sub(1) == 1) {
+            connectQueue_.close();
+        }
+    }
+
+    void BlockPipeline::connectLoop() {
+        std::map<uint64_t, JobPtr> waiting; // Blocks that overtook a lower sequence number
+        uint64_t nextSequence = 0;
+        bool halted = false;                // An earlier block was invalid (stopOnInvalid) or failed to connect
+
+        while (std::optional<JobPtr> next = connectQueue_.pop()) {
+            const uint64_t sequence = (*next)->sequence;
+            waiting.emplace(sequence, std::move(*next));
+
+            for (auto it = waiting.find(nextSequence); it != waiting.end(); it = waiting.find(nextSequence)) {
+                Job& job = *it->second;
+                PipelineResult result = std::move(job.result);
+                result.sequence = job.sequence;
+
+                if (halted || (!job.failed && !job.block)) {
+                    result.status = PipelineStatus::Skipped;
+                    result.blockHash.clear();
+                } else if (job.failed) {
+                    halted = options_.stopOnInvalid;
+                } else {
+                    try {
+                        connect_(*job.block);
+                        result.status = PipelineStatus::Connected;
+                    } catch (...) {
+                        // Later blocks build on this one, so nothing after it can be connected
+                        connectError_ = std::current_exception();
+                        result.status = PipelineStatus::Skipped;
+                        halted = true;
+                        markInvalid(job, PipelineStatus::Skipped);
+                    }
+                }
+
+                results_.push_back(std::move(result));
+                waiting.erase(it);
+                ++nextSequence;
+            }
+        }
+    }
+} // namespace SPHINXBlock
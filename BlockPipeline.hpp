@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKPIPELINE_HPP
+#define SPHINXBLOCKPIPELINE_HPP
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "Block.hpp"
+#include "BoundedQueue.hpp"
+#include "HeaderValidator.hpp"
+#include "Utxo.hpp"
+
+
+namespace SPHINXBlock {
+    class CheckpointIndex; // Forward declaration of the CheckpointIndex class
+    class HeaderIndex;     // Forward declaration of the HeaderIndex class
+
+    // Outcome of one block passing through the pipeline
+    enum class PipelineStatus {
+        Connected,          // Valid and applied to the UTXO set
+        Malformed,          // The block data could not be decoded, or checking it threw
+        InvalidHeader,      // Rejected by the header pre-validation (timestamp, difficulty or proof of work; not linkage)
+        InvalidMerkleRoot,  // The stored Merkle root does not match the transactions
+        InvalidSignature,   // The SPHINCS+ signature does not verify against the public key
+        InvalidCheckpoint,  // The block hash contradicts the checkpoint at its height
+        Skipped             // Not connected because an earlier block was invalid (stopOnInvalid)
+    };
+
+    struct PipelineResult {
+        uint64_t sequence = 0;                      // Submission order, starting at 0
+        PipelineStatus status = PipelineStatus::Skipped;
+        std::string blockHash;                      // Empty for malformed and skipped blocks
+        std::string error;                          // Exception message for malformed blocks
+        HeaderStatus headerStatus = HeaderStatus::Valid;    // Reason for InvalidHeader
+    };
+
+    struct BlockPipelineOptions {
+        std::size_t queueCapacity = 64;             // Blocks buffered between two stages (bounds memory during sync)
+        unsigned int parseThreads = 1;              // Workers decoding block data
+        unsigned int signatureThreads = 0;          // Workers checking signatures (0 = std::thread::hardware_concurrency())
+        bool stopOnInvalid = true;                  // Skip every block after the first invalid one
+        const CheckpointIndex* checkpoints = nullptr;   // Enforce these checkpoints
+        const HeaderIndex* headerChain = nullptr;       // Validated headers; with checkpoints, skip signatures on the chain to the last one
+        const HeaderValidationOptions* headerValidation = nullptr;  // Pre-validate headers (checkHeader, no linkage) before decoding the body
+    };
+
+    // Multi-stage validation pipeline for sync: parse -> hash and Merkle root -> signature -> connect.
+    // Every stage runs on its own thread(s) with bounded queues in between, and blocks are connected
+    // strictly in submission order.
+    class BlockPipeline {
+    public:
+        // Called on the connect thread for each valid block, in submission order
+        using ConnectFunction = std::function<void(const Block&)>;
+
+        BlockPipeline(const SPHINXMerkleBlock::SPHINXPubKey& publicKey, ConnectFunction connect,
+                      const BlockPipelineOptions& options = BlockPipelineOptions());
+
+        // Connect through SPHINXUtxo::updateUTXOSet on the given set
+        BlockPipeline(const SPHINXMerkleBlock::SPHINXPubKey& publicKey, std::map<std::string, SPHINXUtxo::UTXO>& utxoSet,
+                      const BlockPipelineOptions& options = BlockPipelineOptions());
+
+        ~BlockPipeline(); // Finishes every submitted block before returning
+
+        BlockPipeline(const BlockPipeline&) = delete;
+        BlockPipeline& operator=(const BlockPipeline&) = delete;
+
+        // Queue encoded block data (binary or JSON) or an already decoded block; returns its sequence number.
+        // Blocks the caller while the first queue is full.
+        uint64_t submit(std::string blockData);
+        uint64_t submit(Block block);
+
+        // Stop accepting blocks, wait for the pipeline to drain and return one result per block in submission
+        // order. Rethrows the first exception raised by the connect function.
+        std::vector<PipelineResult> finish();
+
+    private:
+        struct Job {
+            uint64_t sequence = 0;
+            std::string blockData;                  // Input of the parse stage
+            std::unique_ptr<Block> block;           // Set once decoded
+            PipelineResult result;
+            bool failed = false;                    // A stage found the block invalid
+            bool assumeValid = false;               // On the header chain to the last checkpoint; the signature stage passes it on
+        };
+        using JobPtr = std::unique_ptr<Job>;
+
+        void start();
+        void preValidateHeader(Job& job);
+        void parseLoop();
+        void hashLoop();
+        void signatureLoop();
+        void connectLoop();
+
+        // Record an invalid block so the stages can skip the blocks after it
+        void markInvalid(Job& job, PipelineStatus status);
+        void markMalformed(Job& job);   // Called from a catch block: records the active exception
+        bool isPastInvalid(uint64_t sequence) const;
+
+        SPHINXMerkleBlock::SPHINXPubKey publicKey_;
+        ConnectFunction connect_;
+        BlockPipelineOptions options_;
+        std::unordered_set<Digest, DigestHasher> assumedValid_;    // Hashes whose signature check is skipped (read-only once started)
+
+        BoundedQueue<JobPtr> parseQueue_;
+        BoundedQueue<JobPtr> hashQueue_;
+        BoundedQueue<JobPtr> signatureQueue_;
+        BoundedQueue<JobPtr> connectQueue_;
+
+        std::atomic<unsigned int> parseWorkers_;        // Parse workers still running; the last one closes hashQueue_
+        std::atomic<unsigned int> signatureWorkers_;    // Signature workers still running; the last one closes connectQueue_
+        std::atomic<uint64_t> firstInvalid_;            // Lowest sequence found invalid (UINT64_MAX = none)
+
+        std::mutex submitMutex_;
+        uint64_t submitted_;
+        bool finished_;
+
+        std::vector<PipelineResult> results_;           // Written by the connect thread only
+        std::exception_ptr connectError_;
+        std::vector<std::thread> threads_;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKPIPELINE_HPP
@@ -0,0 +1,428 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the BlockStore class, a segmented append-only block file that replaces one file per block.
+
+// Segments:
+    // Blocks are appended to numbered segment files (blk00000.dat, blk00001.dat, ...) in the store directory.
+    // A new segment is started once the active one would grow past maxSegmentSize. Each record is a 48-byte
+    // record header (magic "SPXR", payload size, block height, FNV-1a checksum of the payload, 32-byte block
+    // hash) followed by the block in the binary format of BlockCodec.hpp.
+
+// Reading:
+    // Every segment is mapped read-only with mmap, sized to at least maxSegmentSize so the mapping never has
+    // to move while the file grows. read() therefore returns views straight into the mapping, and a
+    // BlockReader can decode a block in place without copying it. readHeaderByHeight/readHeaderByHash decode
+    // only the header fields of the record.
+
+// Indexes and recovery:
+    // Height -> location and hash -> location indexes are kept in memory and rebuilt on open by scanning the
+    // record headers. A torn or corrupt record at the end of the last segment (e.g. after a crash) is cut off.
+
+// Durability:
+    // FsyncPolicy selects whether appends are synced never, per record, every N records or on an interval.
+    // flush() and the destructor always sync the active segment. The directory is synced whenever a segment
+    // file is created, so a synced record is never lost with its segment's directory entry.
+    // Appending a block whose hash is already indexed writes nothing and returns the stored location.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BlockStore.hpp"
+#include "Block.hpp"
+#include "BlockHeader.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        constexpr uint32_t RECORD_MAGIC = 0x52585053;  // "SPXR" little-endian
+        constexpr std::size_t RECORD_HEADER_SIZE = 16 + HASH_FIELD_SIZE;
+
+        uint32_t checksum(std::string_view data) {
+            uint32_t hash = 2166136261u;  // FNV-1a
+            for (char c : data) {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        void putUint32(char* out, uint32_t value) {
+            for (int i = 0; i < 4; ++i) {
+                out[i] = static_cast<char>(value >> (8 * i));
+            }
+        }
+
+        uint32_t getUint32(const char* in) {
+            uint32_t value = 0;
+            for (int i = 0; i < 4; ++i) {
+                value |= uint32_t(static_cast<uint8_t>(in[i])) << (8 * i);
+            }
+            return value;
+        }
+
+        std::runtime_error systemError(const std::string& what, const std::string& path) {
+            return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    BlockStore::BlockStore(const std::string& directory, const BlockStoreOptions& options)
+        : directory_(directory), options_(options), blockCount_(0), unsyncedRecords_(0),
+          lastSync_(std::chrono::steady_clock::now()) {
+        std::filesystem::create_directories(directory_);
+
+        // Reopen the existing segments in order and rebuild the indexes from their records
+        uint32_t segment = 0;
+        while (std::filesystem::exists(segmentPath(segment))) {
+            openSegment(segment, false);
+            scanSegment(segment);
+            ++segment;
+        }
+        if (segments_.empty()) {
+            openSegment(0, true);
+        }
+    }
+
+    BlockStore::~BlockStore() {
+        try {
+            flush();
+        } catch (...) {
+            // Destructors must not throw; the records are still in the page cache
+        }
+        for (const std::unique_ptr<Segment>& segment : segments_) {
+            if (segment->map != nullptr) {
+                ::munmap(const_cast<char*>(segment->map), segment->mapSize);
+            }
+            if (segment->fd >= 0) {
+                ::close(segment->fd);
+            }
+        }
+    }
+
+    std::string BlockStore::segmentPath(uint32_t segment) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "blk%05u.dat", segment);
+        return (std::filesystem::path(directory_) / name).string();
+    }
+
+    void BlockStore::openSegment(uint32_t segment, bool create) {
+        const std::string path = segmentPath(segment);
+        auto entry = std::make_unique<Segment>();
+
+        entry->fd = ::open(path.c_str(), O_RDWR | (create ? O_CREAT : 0), 0644);
+        if (entry->fd < 0) {
+            throw systemError("Failed to open block segment", path);
+        }
+
+        struct stat info;
+        if (::fstat(entry->fd, &info) != 0) {
+            ::close(entry->fd);
+            throw systemError("Failed to stat block segment", path);
+        }
+        entry->fileSize = static_cast<std::size_t>(info.st_size);
+
+        // Map past the end of the file so appended records become visible without remapping
+        entry->mapSize = std::max(options_.maxSegmentSize, entry->fileSize);
+        void* map = ::mmap(nullptr, entry->mapSize, PROT_READ, MAP_SHARED, entry->fd, 0);
+        if (map == MAP_FAILED) {
+            ::close(entry->fd);
+            throw systemError("Failed to map block segment", path);
+        }
+        entry->map = static_cast<const char*>(map);
+
+        if (create) {
+            syncDirectory(); // Make the new segment's directory entry durable along with its records
+        }
+
+        std::unique_lock<std::shared_mutex> lock(indexMutex_);
+        segments_.push_back(std::move(entry));
+    }
+
+    void BlockStore::syncDirectory() const {
+        const int fd = ::open(directory_.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            throw systemError("Failed to open block store directory", directory_);
+        }
+        const int result = ::fsync(fd);
+        ::close(fd);
+        if (result != 0) {
+            throw systemError("Failed to sync block store directory", directory_);
+        }
+    }
+
+    void BlockStore::scanSegment(uint32_t segment) {
+        Segment& entry = *segments_[segment];
+        std::size_t offset = 0;
+
+        while (offset + RECORD_HEADER_SIZE <= entry.fileSize) {
+            const char* header = entry.map + offset;
+            const uint32_t payloadSize = getUint32(header + 4);
+            if (getUint32(header) != RECORD_MAGIC || payloadSize > entry.fileSize - offset - RECORD_HEADER_SIZE) {
+                break;
+            }
+
+            const std::string_view payload(header + RECORD_HEADER_SIZE, payloadSize);
+            if (getUint32(header + 12) != checksum(payload)) {
+                break;
+            }
+
+            Digest digest;
+            std::memcpy(digest.data(), header + 16, HASH_FIELD_SIZE);
+
+            const BlockLocation location{segment, offset + RECORD_HEADER_SIZE, payloadSize};
+            byHeight_[getUint32(header + 8)] = location;
+            if (byHash_.insert_or_assign(encodeDigest(digest), location).second) {
+                ++blockCount_;  // A block stored twice (by an older version) counts once
+            }
+
+            offset += RECORD_HEADER_SIZE + payloadSize;
+        }
+
+        if (offset != entry.fileSize) {
+            if (std::filesystem::exists(segmentPath(segment + 1))) {
+                throw std::runtime_error("Corrupt record in block segment " + segmentPath(segment));
+            }
+            // Torn write at the tail of the last segment: drop it
+            if (::ftruncate(entry.fd, static_cast<off_t>(offset)) != 0) {
+                throw systemError("Failed to truncate block segment", segmentPath(segment));
+            }
+            entry.fileSize = offset;
+        }
+    }
+
+    BlockLocation BlockStore::append(const Block& block) {
+        return append(block.getBlockHeight(), block.getBlockHash(), block.toBinary());
+    }
+
+    BlockLocation BlockStore::append(uint32_t blockHeight, const std::string& blockHash, std::string_view blockData) {
+        if (blockData.size() > UINT32_MAX) {
+            throw std::length_error("Block is too large for the block store");
+        }
+
+        // Build the record header
+        char header[RECORD_HEADER_SIZE];
+        const Digest digest = decodeDigest(blockHash);
+        putUint32(header, RECORD_MAGIC);
+        putUint32(header + 4, static_cast<uint32_t>(blockData.size()));
+        putUint32(header + 8, blockHeight);
+        putUint32(header + 12, checksum(blockData));
+        std::memcpy(header + 16, digest.data(), HASH_FIELD_SIZE);
+
+        std::lock_guard<std::mutex> appendLock(appendMutex_);
+        {
+            // Appending a block that is already stored is a no-op
+            std::shared_lock<std::shared_mutex> lock(indexMutex_);
+            auto it = byHash_.find(encodeDigest(digest));
+            if (it != byHash_.end()) {
+                return it->second;
+            }
+        }
+        const std::size_t recordSize = RECORD_HEADER_SIZE + blockData.size();
+
+        uint32_t segment = static_cast<uint32_t>(segments_.size() - 1);
+        if (segments_[segment]->fileSize > 0 && segments_[segment]->fileSize + recordSize > options_.maxSegmentSize) {
+            // Roll over to a new segment
+            syncActive();
+            ++segment;
+            openSegment(segment, true);
+        }
+
+        Segment& active = *segments_[segment];
+        if (recordSize > active.mapSize) {
+            // A single oversized block in an empty segment: grow the mapping (no views into it exist yet)
+            ::munmap(const_cast<char*>(active.map), active.mapSize);
+            void* map = ::mmap(nullptr, recordSize, PROT_READ, MAP_SHARED, active.fd, 0);
+            if (map == MAP_FAILED) {
+                throw systemError("Failed to map block segment", segmentPath(segment));
+            }
+            active.map = static_cast<const char*>(map);
+            active.mapSize = recordSize;
+        }
+
+        // Write the record header and the payload at the end of the segment
+        const std::string_view parts[2] = {std::string_view(header, RECORD_HEADER_SIZE), blockData};
+        off_t position = static_cast<off_t>(active.fileSize);
+        for (std::string_view part : parts) {
+            while (!part.empty()) {
+                const ssize_t written = ::pwrite(active.fd, part.data(), part.size(), position);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw systemError("Failed to append to block segment", segmentPath(segment));
+                }
+                part.remove_prefix(static_cast<std::size_t>(written));
+                position += written;
+            }
+        }
+
+        const BlockLocation location{segment, active.fileSize + RECORD_HEADER_SIZE, static_cast<uint32_t>(blockData.size())};
+        {
+            std::unique_lock<std::shared_mutex> lock(indexMutex_);
+            active.fileSize += recordSize;
+            byHeight_[blockHeight] = location;
+            byHash_[encodeDigest(digest)] = location;  // Same key form the scan on open produces
+            ++blockCount_;
+        }
+
+        afterAppend();
+        return location;
+    }
+
+    void BlockStore::afterAppend() {
+        ++unsyncedRecords_;
+        switch (options_.fsyncPolicy) {
+            case FsyncPolicy::Never:
+                break;
+            case FsyncPolicy::EveryRecord:
+                syncActive();
+                break;
+            case FsyncPolicy::EveryNRecords:
+                if (unsyncedRecords_ >= options_.fsyncEveryRecords) {
+                    syncActive();
+                }
+                break;
+            case FsyncPolicy::Interval:
+                if (std::chrono::steady_clock::now() - lastSync_ >= options_.fsyncInterval) {
+                    syncActive();
+                }
+                break;
+        }
+    }
+
+    void BlockStore::syncActive() {
+        if (unsyncedRecords_ == 0) {
+            return;
+        }
+        const uint32_t segment = static_cast<uint32_t>(segments_.size() - 1);
+        if (::fdatasync(segments_[segment]->fd) != 0) {
+            throw systemError("Failed to sync block segment", segmentPath(segment));
+        }
+        unsyncedRecords_ = 0;
+        lastSync_ = std::chrono::steady_clock::now();
+    }
+
+    void BlockStore::flush() {
+        std::lock_guard<std::mutex> appendLock(appendMutex_);
+        syncActive();
+    }
+
+    std::optional<BlockLocation> BlockStore::findByHeight(uint32_t blockHeight) const {
+        std::shared_lock<std::shared_mutex> lock(indexMutex_);
+        auto it = byHeight_.find(blockHeight);
+        if (it == byHeight_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::optional<BlockLocation> BlockStore::findByHash(const std::string& blockHash) const {
+        std::string key;
+        try {
+            key = encodeDigest(decodeDigest(blockHash));  // Normalize to the indexed form
+        } catch (const std::invalid_argument&) {
+            return std::nullopt;
+        }
+
+        std::shared_lock<std::shared_mutex> lock(indexMutex_);
+        auto it = byHash_.find(key);
+        if (it == byHash_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::string_view BlockStore::read(const BlockLocation& location) const {
+        std::shared_lock<std::shared_mutex> lock(indexMutex_);
+        if (location.segment >= segments_.size() ||
+            location.offset + location.size > segments_[location.segment]->fileSize) {
+            throw std::out_of_range("Block location is outside the block store");
+        }
+        return std::string_view(segments_[location.segment]->map + location.offset, location.size);
+    }
+
+    std::optional<BlockReader> BlockStore::readByHeight(uint32_t blockHeight) const {
+        std::optional<BlockLocation> location = findByHeight(blockHeight);
+        if (!location) {
+            return std::nullopt;
+        }
+        return BlockReader(read(*location));
+    }
+
+    std::optional<BlockReader> BlockStore::readByHash(const std::string& blockHash) const {
+        std::optional<BlockLocation> location = findByHash(blockHash);
+        if (!location) {
+            return std::nullopt;
+        }
+        return BlockReader(read(*location));
+    }
+
+    std::optional<BlockHeader> BlockStore::readHeaderByHeight(uint32_t blockHeight) const {
+        std::optional<BlockLocation> location = findByHeight(blockHeight);
+        if (!location) {
+            return std::nullopt;
+        }
+        return readBlockHeader(read(*location));
+    }
+
+    std::optional<BlockHeader> BlockStore::readHeaderByHash(const std::string& blockHash) const {
+        std::optional<BlockLocation> location = findByHash(blockHash);
+        if (!location) {
+            return std::nullopt;
+        }
+        return readBlockHeader(read(*location));
+    }
+
+    Block BlockStore::loadByHeight(uint32_t blockHeight) const {
+        std::optional<BlockLocation> location = findByHeight(blockHeight);
+        if (!location) {
+            throw std::runtime_error("Block not found in block store at height " + std::to_string(blockHeight));
+        }
+        return Block::deserialize(read(*location));
+    }
+
+    Block BlockStore::loadByHash(const std::string& blockHash) const {
+        std::optional<BlockLocation> location = findByHash(blockHash);
+        if (!location) {
+            throw std::runtime_error("Block not found in block store: " + blockHash);
+        }
+        return Block::deserialize(read(*location));
+    }
+
+    std::size_t BlockStore::getBlockCount() const {
+        std::shared_lock<std::shared_mutex> lock(indexMutex_);
+        return blockCount_;
+    }
+
+    const std::string& BlockStore::getDirectory() const {
+        return directory_;
+    }
+} // namespace SPHINXBlock
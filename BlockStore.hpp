@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKSTORE_HPP
+#define SPHINXBLOCKSTORE_HPP
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "BlockCodec.hpp"
+
+
+namespace SPHINXBlock {
+    class Block; // Forward declaration of the Block class
+
+    // When appended records are forced to stable storage
+    enum class FsyncPolicy {
+        Never,          // Leave it to the OS (and explicit flush() calls)
+        EveryRecord,    // fdatasync after every append
+        EveryNRecords,  // fdatasync after every fsyncEveryRecords appends
+        Interval        // fdatasync on append once fsyncInterval has passed since the last sync
+    };
+
+    struct BlockStoreOptions {
+        std::size_t maxSegmentSize = std::size_t(128) << 20;   // Size at which a new segment file is started
+        FsyncPolicy fsyncPolicy = FsyncPolicy::EveryNRecords;   // Durability policy for appends
+        uint32_t fsyncEveryRecords = 64;                        // Batch size for FsyncPolicy::EveryNRecords
+        std::chrono::milliseconds fsyncInterval{1000};          // Period for FsyncPolicy::Interval
+    };
+
+    // Position of a block payload inside the store
+    struct BlockLocation {
+        uint32_t segment = 0;   // Segment file number
+        uint64_t offset = 0;    // Offset of the payload inside the segment
+        uint32_t size = 0;      // Size of the payload in bytes
+    };
+
+    // Segmented, append-only block file with height and hash indexes; segments are read through mmap
+    class BlockStore {
+    public:
+        explicit BlockStore(const std::string& directory, const BlockStoreOptions& options = BlockStoreOptions());
+        ~BlockStore();
+
+        BlockStore(const BlockStore&) = delete;
+        BlockStore& operator=(const BlockStore&) = delete;
+
+        // Append a block in binary format and index it by height and hash (a block already stored is not written again)
+        BlockLocation append(const Block& block);
+        BlockLocation append(uint32_t blockHeight, const std::string& blockHash, std::string_view blockData);
+
+        // Index lookups
+        std::optional<BlockLocation> findByHeight(uint32_t blockHeight) const;
+        std::optional<BlockLocation> findByHash(const std::string& blockHash) const;
+
+        // Zero-copy access to a stored payload; the view stays valid for the lifetime of the store
+        std::string_view read(const BlockLocation& location) const;
+
+        // Read a block in place (BlockReader), read only its header, or materialize it as a Block
+        std::optional<BlockReader> readByHeight(uint32_t blockHeight) const;
+        std::optional<BlockReader> readByHash(const std::string& blockHash) const;
+        std::optional<BlockHeader> readHeaderByHeight(uint32_t blockHeight) const;
+        std::optional<BlockHeader> readHeaderByHash(const std::string& blockHash) const;
+        Block loadByHeight(uint32_t blockHeight) const;
+        Block loadByHash(const std::string& blockHash) const;
+
+        // Force all appended records to stable storage
+        void flush();
+
+        std::size_t getBlockCount() const;
+        const std::string& getDirectory() const;
+
+    private:
+        struct Segment {
+            int fd = -1;                    // File descriptor (read/write for the active segment)
+            const char* map = nullptr;      // Read-only mapping of mapSize bytes
+            std::size_t mapSize = 0;
+            std::size_t fileSize = 0;       // Bytes of valid records
+        };
+
+        std::string segmentPath(uint32_t segment) const;
+        void openSegment(uint32_t segment, bool create);
+        void scanSegment(uint32_t segment);
+        void syncDirectory() const;
+        void syncActive();
+        void afterAppend();
+
+        std::string directory_;
+        BlockStoreOptions options_;
+        std::vector<std::unique_ptr<Segment>> segments_;
+        std::unordered_map<uint32_t, BlockLocation> byHeight_;
+        std::unordered_map<std::string, BlockLocation> byHash_;
+        std::size_t blockCount_;
+        uint32_t unsyncedRecords_;
+        std::chrono::steady_clock::time_point lastSync_;
+        mutable std::shared_mutex indexMutex_;  // Guards the indexes and the segment list
+        std::mutex appendMutex_;                // Serializes writers
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKSTORE_HPP
@@ -0,0 +1,290 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the BlockTemplateBuilder class, which assembles candidate blocks for mining from the mempool.
+
+// Selection:
+    // reset() sorts the snapshot by fee per byte and takes transactions greedily while they fit maxTransactions
+    // and maxBytes; a transaction that does not fit is skipped, so smaller ones further down can still fill the
+    // remaining bytes. Transactions are opaque strings here, so dependencies between them are not tracked.
+    // Every transaction the builder holds is keyed by its hash (held_), so a transaction offered twice, in the
+    // snapshot or through add(), is only taken once.
+
+// Incremental updates:
+    // The selected transactions form a min-heap on fee rate and the left-out ones a max-heap. add() appends a
+    // transaction that fits to the block (an O(log n) Merkle update). Otherwise it evicts the cheapest selected
+    // transactions, but only if the newcomer pays a better rate and more in total than what it displaces; the
+    // evicted ones wait in the max-heap and are pulled back in if room frees up.
+    // The newcomer and any refilled transactions take over the evicted transactions' positions in the block
+    // (Block::replaceTransaction, again O(log n)). Only when an eviction leaves a hole that nothing fills is the
+    // block rebuilt, once, on the next getBlock() however many transactions arrived in between.
+    // remove() drops mined or expired transactions from both heaps in one pass, refills their room from the
+    // waiting heap the same way and otherwise leaves the holes to that rebuild, so waiting_ only holds
+    // transactions that are still in the mempool.
+
+// Block:
+    // The template is a regular Block: transactions in the arena, Merkle root from the incremental tree, and the
+    // previous hash, height and timestamp of the last reset. Nonce, difficulty and signature are left to the miner.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "BlockTemplate.hpp"
+#include "Block.hpp"
+#include "TransactionArena.hpp"
+#include "Hash.hpp"
+
+
+namespace SPHINXBlock {
+    BlockTemplateBuilder::BlockTemplateBuilder(const std::string& previousHash, uint32_t blockHeight,
+                                               const BlockTemplateOptions& options)
+        : options_(options), totalBytes_(0), totalFees_(0), block_(previousHash), rebuildNeeded_(false) {
+        if (options_.maxTransactions == 0) {
+            options_.maxTransactions = Block::MAX_BLOCK_SIZE;
+        }
+        block_.setBlockHeight(blockHeight);
+    }
+
+    void BlockTemplateBuilder::reset(const std::string& previousHash, uint32_t blockHeight, std::vector<MempoolEntry> mempool) {
+        selected_.clear();
+        waiting_.clear();
+        held_.clear();
+        freeSlots_.clear();
+        totalBytes_ = 0;
+        totalFees_ = 0;
+
+        std::vector<Candidate> candidates;
+        candidates.reserve(mempool.size());
+        for (MempoolEntry& entry : mempool) {
+            candidates.push_back(makeCandidate(std::move(entry)));
+        }
+        std::sort(candidates.begin(), candidates.end(), higherFeeRate);
+
+        // Greedy fill in fee rate order; the block keeps this order
+        TransactionArena transactions;
+        for (Candidate& candidate : candidates) {
+            if (!canEverFit(candidate) || !held_.insert(candidate.hash).second) {
+                continue; // Too large for any template, or a duplicate
+            }
+            if (fits(candidate)) {
+                candidate.position = transactions.size();
+                transactions.append(candidate.entry.transaction);
+                pushSelected(std::move(candidate));
+            } else {
+                waiting_.push_back(std::move(candidate));
+            }
+        }
+        std::make_heap(waiting_.begin(), waiting_.end(), lowerFeeRate);
+
+        block_.setPreviousHash(previousHash);
+        block_.setBlockHeight(blockHeight);
+        block_.setTimestamp(std::time(nullptr));
+        block_.setTransactions(std::move(transactions));
+        rebuildNeeded_ = false;
+    }
+
+    bool BlockTemplateBuilder::add(MempoolEntry entry) {
+        Candidate candidate = makeCandidate(std::move(entry));
+        if (!canEverFit(candidate) || !held_.insert(candidate.hash).second) {
+            return false;
+        }
+        if (fits(candidate)) {
+            select(std::move(candidate));
+            return true;
+        }
+
+        // Make room by evicting cheaper transactions, as long as the newcomer pays a better rate
+        std::vector<Candidate> evicted;
+        uint64_t evictedFees = 0;
+        while (!fits(candidate) && !selected_.empty() && selected_.front().feeRate < candidate.feeRate) {
+            evicted.push_back(evictCheapest());
+            evictedFees += evicted.back().entry.fee;
+        }
+
+        if (fits(candidate) && evictedFees < candidate.entry.fee) {
+            for (const Candidate& displaced : evicted) {
+                freeSlots_.push_back(displaced.position);
+            }
+            select(std::move(candidate));
+            for (Candidate& displaced : evicted) {
+                pushWaiting(std::move(displaced));
+            }
+            refill();
+
+            if (!freeSlots_.empty()) {
+                rebuildNeeded_ = true; // Fewer transactions than before; close the holes in one rebuild
+                freeSlots_.clear();
+            }
+            return true;
+        }
+
+        // Not worth it: put the selection back as it was (the block was not touched)
+        for (Candidate& displaced : evicted) {
+            pushSelected(std::move(displaced));
+        }
+        pushWaiting(std::move(candidate));
+        return false;
+    }
+
+    std::size_t BlockTemplateBuilder::remove(const std::vector<std::string>& transactionHashes) {
+        std::unordered_set<std::string> doomed;
+        for (const std::string& transactionHash : transactionHashes) {
+            if (held_.erase(transactionHash) != 0) {
+                doomed.insert(transactionHash);
+            }
+        }
+        if (doomed.empty()) {
+            return 0;
+        }
+
+        auto isDoomed = [&doomed](const Candidate& candidate) { return doomed.count(candidate.hash) != 0; };
+        waiting_.erase(std::remove_if(waiting_.begin(), waiting_.end(), isDoomed), waiting_.end());
+        std::make_heap(waiting_.begin(), waiting_.end(), lowerFeeRate);
+
+        auto kept = std::stable_partition(selected_.begin(), selected_.end(), [&](const Candidate& candidate) { return !isDoomed(candidate); });
+        for (auto it = kept; it != selected_.end(); ++it) {
+            totalBytes_ -= it->entry.transaction.size();
+            totalFees_ -= it->entry.fee;
+            if (!rebuildNeeded_) {
+                freeSlots_.push_back(it->position);
+            }
+        }
+        selected_.erase(kept, selected_.end());
+        std::make_heap(selected_.begin(), selected_.end(), higherFeeRate);
+
+        refill();
+        if (!freeSlots_.empty()) {
+            rebuildNeeded_ = true; // Close the remaining holes in one rebuild
+            freeSlots_.clear();
+        }
+        return doomed.size();
+    }
+
+    bool BlockTemplateBuilder::remove(const std::string& transactionHash) {
+        return remove(std::vector<std::string>{transactionHash}) != 0;
+    }
+
+    std::string BlockTemplateBuilder::getTransactionHash(std::string_view transaction) {
+        return SPHINXHash::SPHINX_256(std::string(transaction));
+    }
+
+    const Block& BlockTemplateBuilder::getBlock() {
+        if (rebuildNeeded_) {
+            TransactionArena transactions;
+            transactions.reserve(selected_.size(), totalBytes_);
+            for (Candidate& candidate : selected_) {
+                candidate.position = transactions.size();
+                transactions.append(candidate.entry.transaction);
+            }
+            block_.setTransactions(std::move(transactions));
+            rebuildNeeded_ = false;
+        }
+        block_.setMerkleRoot(block_.calculateMerkleRoot()); // Cached by the block's incremental Merkle tree
+        return block_;
+    }
+
+    std::size_t BlockTemplateBuilder::getTransactionCount() const {
+        return selected_.size();
+    }
+
+    std::size_t BlockTemplateBuilder::getTotalBytes() const {
+        return totalBytes_;
+    }
+
+    uint64_t BlockTemplateBuilder::getTotalFees() const {
+        return totalFees_;
+    }
+
+    std::size_t BlockTemplateBuilder::getWaitingCount() const {
+        return waiting_.size();
+    }
+
+    BlockTemplateBuilder::Candidate BlockTemplateBuilder::makeCandidate(MempoolEntry entry) {
+        Candidate candidate;
+        candidate.hash = getTransactionHash(entry.transaction);
+        candidate.feeRate = static_cast<double>(entry.fee) / static_cast<double>(std::max<std::size_t>(1, entry.transaction.size()));
+        candidate.entry = std::move(entry);
+        return candidate;
+    }
+
+    bool BlockTemplateBuilder::lowerFeeRate(const Candidate& a, const Candidate& b) {
+        return a.feeRate < b.feeRate;
+    }
+
+    bool BlockTemplateBuilder::higherFeeRate(const Candidate& a, const Candidate& b) {
+        return a.feeRate > b.feeRate;
+    }
+
+    bool BlockTemplateBuilder::fits(const Candidate& candidate) const {
+        return selected_.size() < options_.maxTransactions &&
+               (options_.maxBytes == 0 || totalBytes_ + candidate.entry.transaction.size() <= options_.maxBytes);
+    }
+
+    bool BlockTemplateBuilder::canEverFit(const Candidate& candidate) const {
+        return options_.maxBytes == 0 || candidate.entry.transaction.size() <= options_.maxBytes;
+    }
+
+    void BlockTemplateBuilder::pushSelected(Candidate candidate) {
+        totalBytes_ += candidate.entry.transaction.size();
+        totalFees_ += candidate.entry.fee;
+        selected_.push_back(std::move(candidate));
+        std::push_heap(selected_.begin(), selected_.end(), higherFeeRate);
+    }
+
+    void BlockTemplateBuilder::pushWaiting(Candidate candidate) {
+        waiting_.push_back(std::move(candidate));
+        std::push_heap(waiting_.begin(), waiting_.end(), lowerFeeRate);
+    }
+
+    void BlockTemplateBuilder::select(Candidate candidate) {
+        if (rebuildNeeded_) {
+            // Positions are assigned by the pending rebuild
+        } else if (!freeSlots_.empty()) {
+            candidate.position = freeSlots_.back();
+            freeSlots_.pop_back();
+            block_.replaceTransaction(candidate.position, candidate.entry.transaction);
+        } else {
+            candidate.position = block_.getTransactionCount();
+            block_.addTransaction(candidate.entry.transaction); // Append and rehash one Merkle path
+        }
+        pushSelected(std::move(candidate));
+    }
+
+    BlockTemplateBuilder::Candidate BlockTemplateBuilder::evictCheapest() {
+        std::pop_heap(selected_.begin(), selected_.end(), higherFeeRate);
+        Candidate cheapest = std::move(selected_.back());
+        selected_.pop_back();
+        totalBytes_ -= cheapest.entry.transaction.size();
+        totalFees_ -= cheapest.entry.fee;
+        return cheapest;
+    }
+
+    void BlockTemplateBuilder::refill() {
+        while (!waiting_.empty() && fits(waiting_.front())) {
+            std::pop_heap(waiting_.begin(), waiting_.end(), lowerFeeRate);
+            Candidate best = std::move(waiting_.back());
+            waiting_.pop_back();
+            select(std::move(best));
+        }
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKTEMPLATE_HPP
+#define SPHINXBLOCKTEMPLATE_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "Block.hpp"
+
+
+namespace SPHINXBlock {
+    // A mempool transaction offered to the template builder
+    struct MempoolEntry {
+        std::string transaction;
+        uint64_t fee = 0;
+    };
+
+    struct BlockTemplateOptions {
+        uint32_t maxTransactions = 0;               // Transaction limit of the template (0 = Block::MAX_BLOCK_SIZE)
+        std::size_t maxBytes = 0;                   // Limit on the total transaction bytes (0 = no byte limit)
+    };
+
+    // Builds a block template from the mempool, picking the transactions with the highest fee per byte that fit
+    // the limits. New transactions update the template in place (an append or replacement with an O(log n) Merkle
+    // update) instead of a rebuild from scratch. Not synchronized.
+    class BlockTemplateBuilder {
+    public:
+        BlockTemplateBuilder(const std::string& previousHash, uint32_t blockHeight,
+                             const BlockTemplateOptions& options = BlockTemplateOptions());
+
+        // Start a new template on top of the given block from a mempool snapshot (duplicates are dropped)
+        void reset(const std::string& previousHash, uint32_t blockHeight, std::vector<MempoolEntry> mempool);
+
+        // Offer a newly arrived transaction; returns true if it made it into the template (possibly evicting
+        // cheaper ones, which are kept as candidates in case room frees up). A transaction the builder already
+        // holds (same hash) is rejected.
+        bool add(MempoolEntry entry);
+
+        // Drop transactions that were mined or left the mempool, selected or waiting, by transaction hash;
+        // returns how many were held. Freed room is refilled from the waiting transactions.
+        std::size_t remove(const std::vector<std::string>& transactionHashes);
+        bool remove(const std::string& transactionHash);
+
+        // The key remove() takes: SPHINX_256 of the transaction bytes
+        static std::string getTransactionHash(std::string_view transaction);
+
+        // The template block, with its Merkle root set and the timestamp of the last reset
+        const Block& getBlock();
+
+        std::size_t getTransactionCount() const;
+        std::size_t getTotalBytes() const;
+        uint64_t getTotalFees() const;
+        std::size_t getWaitingCount() const;    // Mempool transactions left out of the template
+
+    private:
+        struct Candidate {
+            MempoolEntry entry;
+            std::string hash;                   // getTransactionHash(entry.transaction)
+            double feeRate = 0;                 // Fee per transaction byte
+            std::size_t position = 0;           // Index in block_ while selected
+        };
+
+        static Candidate makeCandidate(MempoolEntry entry);
+        static bool lowerFeeRate(const Candidate& a, const Candidate& b);
+        static bool higherFeeRate(const Candidate& a, const Candidate& b);
+
+        bool fits(const Candidate& candidate) const;
+        bool canEverFit(const Candidate& candidate) const;
+        void pushSelected(Candidate candidate);
+        void pushWaiting(Candidate candidate);
+        void select(Candidate candidate);
+        Candidate evictCheapest();
+        void refill();
+
+        BlockTemplateOptions options_;
+        std::vector<Candidate> selected_;       // Min-heap on fee rate: the cheapest selected transaction is evicted first
+        std::vector<Candidate> waiting_;        // Max-heap on fee rate: the best left-out transaction is taken first
+        std::unordered_set<std::string> held_;  // Hashes of every selected and waiting transaction
+        std::size_t totalBytes_;
+        uint64_t totalFees_;
+
+        Block block_;
+        std::vector<std::size_t> freeSlots_;    // Positions in block_ vacated by evictions, reused by the next selections
+        bool rebuildNeeded_;                    // Evictions left holes in block_; it is rebuilt on the next getBlock()
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKTEMPLATE_HPP
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines verifyBlocks, the parallel batch form of Block::verifyBlock.
+
+// Each block is verified by its own task on a ThreadPool: the Merkle root first (cheap), then the block
+// hash and the SPHINCS+ signature (expensive). Results are written to the slot of the block's index, so
+// the returned vector lines up with the input regardless of completion order.
+
+// With checkpoints set, a block whose hash contradicts the checkpoint at its height is InvalidCheckpoint. With a
+// headerChain as well, blocks whose hash is on the header chain leading to the last checkpoint skip the signature
+// check; every other block, including one at a covered height but off that chain, is verified in full.
+
+// With failFast set, the first invalid block raises a shared flag; tasks that have not started yet see
+// the flag and report Skipped instead of doing any hashing or signature work. Tasks are queued in block
+// order, so the blocks after an invalid one are the ones skipped.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <atomic>
+#include <future>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include "BlockVerifier.hpp"
+#include "Block.hpp"
+#include "ThreadPool.hpp"
+#include "CheckpointIndex.hpp"
+#include "HeaderIndex.hpp"
+
+
+namespace SPHINXBlock {
+    std::vector<VerifyStatus> verifyBlocks(std::span<const Block> blocks,
+                                           std::span<const SPHINXMerkleBlock::SPHINXPubKey> publicKeys,
+                                           const VerifyOptions& options) {
+        if (publicKeys.size() != 1 && publicKeys.size() != blocks.size()) {
+            throw std::invalid_argument("verifyBlocks needs one public key or one public key per block");
+        }
+
+        std::vector<VerifyStatus> results(blocks.size(), VerifyStatus::Skipped);
+        if (blocks.empty()) {
+            return results;
+        }
+
+        std::optional<ThreadPool> localPool;
+        ThreadPool* pool = options.pool;
+        if (pool == nullptr) {
+            localPool.emplace(options.threadCount);
+            pool = &*localPool;
+        }
+
+        // Computed once per batch: the tasks only probe it
+        std::unordered_set<Digest, DigestHasher> assumedValid;
+        if (options.checkpoints != nullptr && options.headerChain != nullptr) {
+            assumedValid = options.checkpoints->getAssumedValidChain(*options.headerChain);
+        }
+
+        std::atomic<bool> failed(false);
+        std::vector<std::future<void>> pending;
+        pending.reserve(blocks.size());
+
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            pending.push_back(pool->submit([&, i]() {
+                if (options.failFast && failed.load(std::memory_order_relaxed)) {
+                    return; // Leave the result as Skipped
+                }
+
+                const Block& block = blocks[i];
+                const SPHINXMerkleBlock::SPHINXPubKey& publicKey = publicKeys.size() == 1 ? publicKeys[0] : publicKeys[i];
+
+                VerifyStatus status = VerifyStatus::Valid;
+                if (!block.verifyMerkleRoot(publicKey)) {
+                    status = VerifyStatus::InvalidMerkleRoot;
+                } else if (options.checkpoints != nullptr && !options.checkpoints->matches(block)) {
+                    status = VerifyStatus::InvalidCheckpoint;
+                } else if (!assumedValid.empty() && assumedValid.count(decodeDigest(block.getBlockHash())) != 0) {
+                    status = VerifyStatus::Valid; // On the header chain to the last checkpoint: the signature is assumed valid
+                } else if (!block.verifySignature(publicKey)) {
+                    status = VerifyStatus::InvalidSignature;
+                }
+
+                results[i] = status;
+                if (status != VerifyStatus::Valid) {
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }));
+        }
+
+        // Wait for every task (they reference locals), then surface the first exception if any
+        for (std::future<void>& future : pending) {
+            future.wait();
+        }
+        for (std::future<void>& future : pending) {
+            future.get();
+        }
+
+        return results;
+    }
+} // namespace SPHINXBlock
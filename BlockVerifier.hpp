@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKVERIFIER_HPP
+#define SPHINXBLOCKVERIFIER_HPP
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "Block.hpp"
+
+
+namespace SPHINXBlock {
+    class ThreadPool;      // Forward declaration of the ThreadPool class
+    class CheckpointIndex; // Forward declaration of the CheckpointIndex class
+    class HeaderIndex;     // Forward declaration of the HeaderIndex class
+
+    // Outcome of verifying one block
+    enum class VerifyStatus {
+        Valid,              // Merkle root and signature are both valid
+        InvalidMerkleRoot,  // The stored Merkle root does not match the transactions
+        InvalidSignature,   // The SPHINCS+ signature does not verify against the public key
+        InvalidCheckpoint,  // The block hash contradicts the checkpoint at its height
+        Skipped             // Not checked because fail-fast stopped the batch after an invalid block
+    };
+
+    struct VerifyOptions {
+        bool failFast = false;          // Stop verifying the remaining blocks once one is invalid
+        ThreadPool* pool = nullptr;     // Pool to run on (nullptr = a temporary pool for this batch)
+        unsigned int threadCount = 0;   // Size of the temporary pool (0 = std::thread::hardware_concurrency())
+        const CheckpointIndex* checkpoints = nullptr;  // Enforce these checkpoints
+        const HeaderIndex* headerChain = nullptr;       // Validated headers; with checkpoints, skip signatures on the chain to the last one
+    };
+
+    // Verify a batch of blocks in parallel. publicKeys holds either one key per block or a single key for all of them.
+    std::vector<VerifyStatus> verifyBlocks(std::span<const Block> blocks,
+                                           std::span<const SPHINXMerkleBlock::SPHINXPubKey> publicKeys,
+                                           const VerifyOptions& options = VerifyOptions());
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKVERIFIER_HPP
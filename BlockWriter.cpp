@@ -0,0 +1,219 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the BlockWriter class, a write-behind batching front end for Block::saveToDatabase.
+
+// Pipeline:
+    // submit() hands the block to the thread pool, which computes its hash (the database key) and encodes (and,
+    // with a compressor, compresses) it while the block waits in the queue. A background flusher takes the queued blocks in submission order and
+    // writes them with one database call per batch, so bulk imports and reorg replays are bound by database
+    // bandwidth instead of one round-trip per block.
+
+// Batching:
+    // A batch is written as soon as maxBatchBlocks blocks or maxBatchBytes transaction bytes are waiting, when
+    // the oldest waiting block is flushInterval old, or when flush() or the destructor asks for it.
+
+// Backpressure:
+    // At most maxQueuedBlocks blocks are in flight; submit() blocks until a batch completes and frees room.
+
+// Database interface:
+    // If SPHINXDb::DistributedDb provides saveBatch(records), where records is a vector of (data, key) pairs in
+    // the argument order of saveData, each batch is one saveBatch call; otherwise the batch falls back to
+    // saveData per block on the flusher thread. A failed write fails the futures of every block in the batch.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BlockWriter.hpp"
+#include "BlockCompression.hpp"
+#include "ThreadPool.hpp"
+#include "db.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        using BatchRecords = std::vector<std::pair<std::string, std::string>>; // (data, key) as in saveData
+
+        template <typename Db>
+        void saveRecords(Db& distributedDb, const BatchRecords& records) {
+            if constexpr (requires { distributedDb.saveBatch(records); }) {
+                distributedDb.saveBatch(records);
+            } else {
+                for (const auto& [blockData, blockId] : records) {
+                    distributedDb.saveData(blockData, blockId);
+                }
+            }
+        }
+    }
+
+    BlockWriter::BlockWriter(SPHINXDb::DistributedDb& distributedDb, const BlockWriterOptions& options)
+        : distributedDb_(distributedDb), options_(options), pool_(options.pool), queuedBytes_(0),
+          submitted_(0), completed_(0), flushTarget_(0), stopping_(false) {
+        options_.maxBatchBlocks = std::max<std::size_t>(options_.maxBatchBlocks, 1);
+        options_.maxQueuedBlocks = std::max<std::size_t>(options_.maxQueuedBlocks, 1);
+        if (pool_ == nullptr) {
+            ownedPool_ = std::make_unique<ThreadPool>(options_.threadCount);
+            pool_ = ownedPool_.get();
+        }
+        flusher_ = std::thread(&BlockWriter::flusherLoop, this);
+    }
+
+    BlockWriter::~BlockWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        queueCondition_.notify_all();
+        spaceCondition_.notify_all();
+        flusher_.join(); // The flusher drains the queue before it exits
+    }
+
+    std::future<std::string> BlockWriter::submit(Block block) {
+        auto sharedBlock = std::make_shared<const Block>(std::move(block));
+
+        Pending pending;
+        pending.estimatedBytes = sharedBlock->getTransactionArena().getByteSize();
+        std::future<std::string> done = pending.done.get_future();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        spaceCondition_.wait(lock, [this]() {
+            return stopping_ || submitted_ - completed_ < options_.maxQueuedBlocks;
+        });
+        if (stopping_) {
+            throw std::logic_error("BlockWriter is shutting down");
+        }
+
+        // Hash, encode and compress on the pool while the block waits for its batch
+        const BlockFormat format = options_.format;
+        const BlockCompressor* compressor = options_.compressor;
+        pending.record = pool_->submit([sharedBlock, format, compressor]() {
+            std::string blockData = sharedBlock->serialize(format);
+            if (compressor != nullptr) {
+                blockData = compressBlock(blockData, *compressor);
+            }
+            return Record{sharedBlock->getBlockHash(), std::move(blockData)};
+        });
+        pending.queuedAt = std::chrono::steady_clock::now();
+
+        queuedBytes_ += pending.estimatedBytes;
+        queue_.push_back(std::move(pending));
+        ++submitted_;
+
+        // Wake the flusher to start the interval timer or write a full batch
+        if (queue_.size() == 1 || queue_.size() >= options_.maxBatchBlocks || queuedBytes_ >= options_.maxBatchBytes) {
+            queueCondition_.notify_one();
+        }
+        return done;
+    }
+
+    void BlockWriter::flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const uint64_t target = submitted_;
+        flushTarget_ = std::max(flushTarget_, target);
+        queueCondition_.notify_one();
+        spaceCondition_.wait(lock, [this, target]() { return completed_ >= target; });
+    }
+
+    std::size_t BlockWriter::getPendingCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<std::size_t>(submitted_ - completed_);
+    }
+
+    void BlockWriter::flusherLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            // Wait until a batch is due
+            while (true) {
+                if (queue_.empty()) {
+                    if (stopping_) {
+                        return;
+                    }
+                    queueCondition_.wait(lock);
+                    continue;
+                }
+                if (stopping_ || flushTarget_ > completed_ || queue_.size() >= options_.maxBatchBlocks ||
+                    queuedBytes_ >= options_.maxBatchBytes) {
+                    break;
+                }
+                const auto deadline = queue_.front().queuedAt + options_.flushInterval;
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+                queueCondition_.wait_until(lock, deadline);
+            }
+
+            // Take the oldest blocks, up to the batch limits (a single oversized block still makes a batch)
+            std::deque<Pending> batch;
+            std::size_t batchBytes = 0;
+            while (!queue_.empty() && batch.size() < options_.maxBatchBlocks &&
+                   (batch.empty() || batchBytes + queue_.front().estimatedBytes <= options_.maxBatchBytes)) {
+                batchBytes += queue_.front().estimatedBytes;
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+            queuedBytes_ -= batchBytes;
+
+            lock.unlock();
+            writeBatch(batch);
+            lock.lock();
+
+            completed_ += batch.size();
+            spaceCondition_.notify_all();
+        }
+    }
+
+    void BlockWriter::writeBatch(std::deque<Pending>& batch) {
+        BatchRecords records;
+        std::vector<std::string> blockIds;
+        std::vector<std::size_t> written; // Batch positions that made it into records
+        records.reserve(batch.size());
+        blockIds.reserve(batch.size());
+        written.reserve(batch.size());
+
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            try {
+                Record record = batch[i].record.get();
+                blockIds.push_back(record.blockId);
+                records.emplace_back(std::move(record.blockData), std::move(record.blockId));
+                written.push_back(i);
+            } catch (...) {
+                batch[i].done.set_exception(std::current_exception()); // Only this block failed to encode
+            }
+        }
+        if (records.empty()) {
+            return;
+        }
+
+        try {
+            saveRecords(distributedDb_, records);
+        } catch (...) {
+            const std::exception_ptr error = std::current_exception();
+            for (std::size_t i : written) {
+                batch[i].done.set_exception(error);
+            }
+            return;
+        }
+
+        for (std::size_t k = 0; k < written.size(); ++k) {
+            batch[written[k]].done.set_value(std::move(blockIds[k]));
+        }
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBLOCKWRITER_HPP
+#define SPHINXBLOCKWRITER_HPP
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "Block.hpp"
+#include "BlockCodec.hpp"
+
+
+namespace SPHINXBlock {
+    class ThreadPool;      // Forward declaration of the ThreadPool class
+    class BlockCompressor; // Forward declaration of the BlockCompressor class
+
+    struct BlockWriterOptions {
+        std::size_t maxBatchBlocks = 256;                       // Flush once this many blocks are waiting
+        std::size_t maxBatchBytes = std::size_t(8) << 20;       // ... or once their transactions add up to this many bytes
+        std::chrono::milliseconds flushInterval{50};            // ... or once the oldest waiting block is this old
+        std::size_t maxQueuedBlocks = 4096;                     // submit() blocks while this many blocks are in flight
+        BlockFormat format = BlockFormat::Binary;               // Encoding of the stored records
+        const BlockCompressor* compressor = nullptr;            // Compress the records on the pool (nullptr = store them as encoded)
+        ThreadPool* pool = nullptr;                             // Pool that serializes the blocks (nullptr = a pool owned by the writer)
+        unsigned int threadCount = 0;                           // Size of the owned pool (0 = std::thread::hardware_concurrency())
+    };
+
+    // Write-behind block writer for SPHINXDb::DistributedDb: blocks are serialized and hashed on pool threads as
+    // soon as they are submitted and written in batches by a background flusher
+    class BlockWriter {
+    public:
+        explicit BlockWriter(SPHINXDb::DistributedDb& distributedDb, const BlockWriterOptions& options = BlockWriterOptions());
+        ~BlockWriter(); // Writes every submitted block before returning
+
+        BlockWriter(const BlockWriter&) = delete;
+        BlockWriter& operator=(const BlockWriter&) = delete;
+
+        // Queue a block for writing; the future yields its database key (the block hash) once the batch is stored.
+        // Blocks the caller while maxQueuedBlocks blocks are in flight.
+        std::future<std::string> submit(Block block);
+
+        // Wait until every block submitted so far has been written (or has failed)
+        void flush();
+
+        // Number of blocks submitted but not yet written
+        std::size_t getPendingCount() const;
+
+    private:
+        struct Record {
+            std::string blockId;    // Database key (block hash)
+            std::string blockData;  // Encoded block
+        };
+
+        struct Pending {
+            std::future<Record> record;                 // Serialization running on the pool
+            std::promise<std::string> done;             // Fulfilled when the batch holding the block is stored
+            std::size_t estimatedBytes = 0;             // Transaction bytes, counted against maxBatchBytes
+            std::chrono::steady_clock::time_point queuedAt;
+        };
+
+        void flusherLoop();
+        void writeBatch(std::deque<Pending>& batch);
+
+        SPHINXDb::DistributedDb& distributedDb_;
+        BlockWriterOptions options_;
+        std::unique_ptr<ThreadPool> ownedPool_;
+        ThreadPool* pool_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable queueCondition_;    // Wakes the flusher
+        std::condition_variable spaceCondition_;    // Wakes producers blocked on a full queue and flush() callers
+        std::deque<Pending> queue_;
+        std::size_t queuedBytes_;
+        uint64_t submitted_;                        // Blocks accepted by submit()
+        uint64_t completed_;                        // Blocks written (or failed); batches complete in submission order
+        uint64_t flushTarget_;                      // Write everything up to this count without waiting for a full batch
+        bool stopping_;
+        std::thread flusher_;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXBLOCKWRITER_HPP
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXBOUNDEDQUEUE_HPP
+#define SPHINXBOUNDEDQUEUE_HPP
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+
+namespace SPHINXBlock {
+    // Blocking FIFO with a fixed capacity, used to hand work from one pipeline stage to the next
+    template <typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(std::size_t capacity) : capacity_(capacity == 0 ? 1 : capacity), closed_(false) {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // Add an item, waiting while the queue is full. Returns false (dropping the item) once the queue is closed.
+        bool push(T item) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notFull_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+            if (closed_) {
+                return false;
+            }
+            items_.push_back(std::move(item));
+            lock.unlock();
+            notEmpty_.notify_one();
+            return true;
+        }
+
+        // Take the oldest item, waiting while the queue is empty. Returns nullopt once it is closed and drained.
+        std::optional<T> pop() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+            if (items_.empty()) {
+                return std::nullopt;
+            }
+            std::optional<T> item(std::move(items_.front()));
+            items_.pop_front();
+            lock.unlock();
+            notFull_.notify_one();
+            return item;
+        }
+
+        // Refuse further pushes; consumers still drain the items already queued
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                closed_ = true;
+            }
+            notFull_.notify_all();
+            notEmpty_.notify_all();
+        }
+
+    private:
+        const std::size_t capacity_;
+        std::deque<T> items_;
+        std::mutex mutex_;
+        std::condition_variable notFull_;
+        std::condition_variable notEmpty_;
+        bool closed_;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXBOUNDEDQUEUE_HPP
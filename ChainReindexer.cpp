@@ -0,0 +1,315 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the ChainReindexer class, which rebuilds chain state from already stored blocks.
+
+// Prefetch:
+    // A ThreadPool of ioThreads loads blocks (Block::load or BlockStore::loadByHeight, which read and decode)
+    // up to prefetchBlocks ahead of the block being submitted. The window is independent of the segments below,
+    // so loading never pauses while a segment drains.
+
+// Segments:
+    // Blocks are fed to a BlockPipeline in segments of progressInterval blocks. The pipeline checks Merkle roots
+    // (and checkpoints) on its hash stage and signatures on signatureThreads workers, and connects in order.
+    // When a segment has drained, every block in it is connected, so flush() is called and the progress file
+    // is rewritten (temporary file, fsync, rename, directory fsync) with the next source index and the tip hash.
+
+// Resume:
+    // A run starts after the block recorded in the progress file, once the source block before it is confirmed
+    // to have the recorded hash. flush() must make the connected state durable before the progress is saved;
+    // blocks connected after the last save are connected again, so connect should tolerate seeing them twice.
+
+// Failure:
+    // Each block must extend the previous one (previousHash), so a gap in the source is caught.
+    // The first block that fails to load, verify, link or connect ends the run; the result names its source index.
+    // Progress is kept at the last fully connected segment.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ChainReindexer.hpp"
+#include "Block.hpp"
+#include "BlockStore.hpp"
+#include "ThreadPool.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        std::runtime_error progressError(const std::string& what, const std::string& path) {
+            return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+        }
+
+        // fsync a file or directory by path
+        void syncPath(const std::string& path, int flags) {
+            const int fd = ::open(path.c_str(), flags);
+            if (fd < 0) {
+                throw progressError("Failed to open", path);
+            }
+            const int result = ::fsync(fd);
+            ::close(fd);
+            if (result != 0) {
+                throw progressError("Failed to sync", path);
+            }
+        }
+    }
+
+    // BlockFileSource
+
+    BlockFileSource::BlockFileSource(const std::string& directory) {
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.is_regular_file()) {
+                paths_.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths_.begin(), paths_.end());
+
+        sizes_.reserve(paths_.size());
+        for (const std::string& path : paths_) {
+            sizes_.push_back(static_cast<std::size_t>(std::filesystem::file_size(path)));
+        }
+    }
+
+    std::size_t BlockFileSource::size() const {
+        return paths_.size();
+    }
+
+    Block BlockFileSource::load(std::size_t index) const {
+        return Block::load(paths_.at(index));
+    }
+
+    std::size_t BlockFileSource::getEncodedSize(std::size_t index) const {
+        return sizes_.at(index);
+    }
+
+    // BlockStoreSource
+
+    BlockStoreSource::BlockStoreSource(const BlockStore& blockStore, uint32_t firstHeight)
+        : blockStore_(blockStore), firstHeight_(firstHeight) {
+    }
+
+    std::size_t BlockStoreSource::size() const {
+        // Count the unbroken run of heights from firstHeight (a store may also hold competing branches)
+        std::size_t count = 0;
+        while (blockStore_.findByHeight(firstHeight_ + static_cast<uint32_t>(count))) {
+            ++count;
+        }
+        return count;
+    }
+
+    Block BlockStoreSource::load(std::size_t index) const {
+        return blockStore_.loadByHeight(firstHeight_ + static_cast<uint32_t>(index));
+    }
+
+    std::size_t BlockStoreSource::getEncodedSize(std::size_t index) const {
+        std::optional<BlockLocation> location = blockStore_.findByHeight(firstHeight_ + static_cast<uint32_t>(index));
+        return location ? location->size : 0;
+    }
+
+    // ReindexStats
+
+    double ReindexStats::getBlocksPerSecond() const {
+        return seconds > 0 ? static_cast<double>(blocks) / seconds : 0;
+    }
+
+    double ReindexStats::getMegabytesPerSecond() const {
+        return seconds > 0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0;
+    }
+
+    // ChainReindexer
+
+    ChainReindexer::ChainReindexer(const SPHINXMerkleBlock::SPHINXPubKey& publicKey, const ReindexOptions& options)
+        : publicKey_(publicKey), options_(options) {
+        options_.prefetchBlocks = std::max<std::size_t>(1, options_.prefetchBlocks);
+        options_.progressInterval = std::max<std::size_t>(1, options_.progressInterval);
+    }
+
+    ReindexResult ChainReindexer::run(const ReindexSource& source, const BlockPipeline::ConnectFunction& connect) {
+        const auto started = std::chrono::steady_clock::now();
+        const std::size_t total = source.size();
+
+        ReindexResult result;
+        ReindexStats& stats = result.stats;
+
+        if (std::optional<Progress> progress = loadProgress()) {
+            if (progress->nextIndex > total ||
+                (progress->nextIndex > 0 && source.load(progress->nextIndex - 1).getBlockHash() != progress->tipHash)) {
+                throw std::runtime_error("Reindex progress file " + options_.progressFile + " does not match the block source");
+            }
+            stats.nextIndex = progress->nextIndex;
+            stats.tipHash = progress->tipHash;
+        }
+
+        struct LoadedBlock {
+            std::optional<Block> block;
+            std::size_t bytes = 0;
+            std::string error;
+        };
+
+        ThreadPool ioPool(options_.ioThreads);
+        std::deque<std::future<LoadedBlock>> prefetched;
+        std::size_t nextToLoad = stats.nextIndex;
+        auto fillWindow = [&]() {
+            while (nextToLoad < total && prefetched.size() < options_.prefetchBlocks) {
+                const std::size_t index = nextToLoad++;
+                prefetched.push_back(ioPool.submit([&source, index]() {
+                    LoadedBlock loaded;
+                    try {
+                        loaded.block.emplace(source.load(index));
+                        loaded.bytes = source.getEncodedSize(index);
+                    } catch (const std::exception& e) {
+                        loaded.error = e.what();
+                    }
+                    return loaded;
+                }));
+            }
+        };
+
+        BlockPipelineOptions pipelineOptions;
+        pipelineOptions.signatureThreads = options_.signatureThreads;
+        pipelineOptions.checkpoints = options_.checkpoints;
+        pipelineOptions.headerChain = options_.headerChain;
+
+        while (stats.nextIndex < total) {
+            const std::size_t segmentBegin = stats.nextIndex;
+            const std::size_t segmentEnd = std::min(total, segmentBegin + options_.progressInterval);
+
+            std::vector<std::string> hashes; // Filled on the connect thread, read after finish()
+            std::vector<std::size_t> sizes;  // Encoded size of each submitted block
+            std::optional<std::size_t> loadFailure;
+
+            BlockPipeline pipeline(publicKey_, [&connect, &hashes, &stats](const Block& block) {
+                const std::string& tipHash = hashes.empty() ? stats.tipHash : hashes.back();
+                if (!tipHash.empty() && block.getPreviousHash() != tipHash) {
+                    throw std::runtime_error("Block " + block.getBlockHash() + " does not extend " + tipHash);
+                }
+                connect(block);
+                hashes.push_back(block.getBlockHash());
+            }, pipelineOptions);
+
+            for (std::size_t index = segmentBegin; index < segmentEnd; ++index) {
+                fillWindow();
+                LoadedBlock loaded = prefetched.front().get();
+                prefetched.pop_front();
+                if (!loaded.block) {
+                    loadFailure = index;
+                    result.error = loaded.error;
+                    break;
+                }
+                sizes.push_back(loaded.bytes);
+                pipeline.submit(std::move(*loaded.block));
+            }
+
+            std::vector<PipelineResult> results;
+            try {
+                results = pipeline.finish();
+            } catch (const std::exception& e) {
+                result.error = e.what(); // The connect function failed; its block is reported as Skipped
+            }
+
+            // Account for the connected prefix of the segment
+            const std::size_t connected = hashes.size();
+            stats.blocks += connected;
+            stats.nextIndex = segmentBegin + connected;
+            if (connected > 0) {
+                stats.tipHash = hashes.back();
+            }
+            for (std::size_t i = 0; i < connected; ++i) {
+                stats.bytes += sizes[i];
+            }
+
+            if (connected < sizes.size() || loadFailure || !result.error.empty()) {
+                result.failedIndex = stats.nextIndex;
+                result.failedStatus = connected < results.size() ? results[connected].status
+                                    : loadFailure ? PipelineStatus::Malformed : PipelineStatus::Skipped;
+                if (connected < results.size() && !results[connected].error.empty()) {
+                    result.error = results[connected].error;
+                }
+                break;
+            }
+
+            if (options_.flush) {
+                options_.flush();
+            }
+            saveProgress(Progress{stats.nextIndex, stats.tipHash});
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            if (options_.onProgress) {
+                options_.onProgress(stats);
+            }
+        }
+
+        // Let outstanding loads finish before the pool and the source go away
+        for (std::future<LoadedBlock>& pending : prefetched) {
+            pending.wait();
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        result.complete = stats.nextIndex == total && !result.failedIndex;
+        return result;
+    }
+
+    std::optional<ChainReindexer::Progress> ChainReindexer::loadProgress() const {
+        if (options_.progressFile.empty()) {
+            return std::nullopt;
+        }
+        std::ifstream input(options_.progressFile);
+        if (!input.is_open()) {
+            return std::nullopt; // First run
+        }
+
+        Progress progress;
+        if (!(input >> progress.nextIndex)) {
+            throw std::runtime_error("Malformed reindex progress file: " + options_.progressFile);
+        }
+        input >> progress.tipHash;
+        return progress;
+    }
+
+    void ChainReindexer::saveProgress(const Progress& progress) const {
+        if (options_.progressFile.empty()) {
+            return;
+        }
+        // Replace the file so a crash leaves either the old or the new progress: the new contents are synced
+        // before the rename, and the directory after it, so the rename cannot reach disk ahead of the data
+        const std::string temporary = options_.progressFile + ".tmp";
+        {
+            std::ofstream output(temporary, std::ios::trunc);
+            output << progress.nextIndex << ' ' << progress.tipHash << '\n';
+            if (!output.flush()) {
+                throw std::runtime_error("Failed to write reindex progress file: " + temporary);
+            }
+        }
+        syncPath(temporary, O_RDONLY);
+        std::filesystem::rename(temporary, options_.progressFile);
+
+        const std::filesystem::path directory = std::filesystem::path(options_.progressFile).parent_path();
+        syncPath(directory.empty() ? "." : directory.string(), O_RDONLY | O_DIRECTORY);
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXCHAINREINDEXER_HPP
+#define SPHINXCHAINREINDEXER_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Block.hpp"
+#include "BlockPipeline.hpp"
+
+
+namespace SPHINXBlock {
+    class BlockStore;      // Forward declaration of the BlockStore class
+    class CheckpointIndex; // Forward declaration of the CheckpointIndex class
+    class HeaderIndex;     // Forward declaration of the HeaderIndex class
+
+    // Stored blocks in chain order. load() and getEncodedSize() are called concurrently from the I/O threads.
+    class ReindexSource {
+    public:
+        virtual ~ReindexSource() = default;
+
+        virtual std::size_t size() const = 0;
+        virtual Block load(std::size_t index) const = 0;
+        virtual std::size_t getEncodedSize(std::size_t index) const = 0;   // Bytes read for the block (for MB/s)
+    };
+
+    // Block files written by Block::save, in file name order (name them by zero-padded height)
+    class BlockFileSource : public ReindexSource {
+    public:
+        explicit BlockFileSource(const std::string& directory);
+
+        std::size_t size() const override;
+        Block load(std::size_t index) const override;       // Block::load
+        std::size_t getEncodedSize(std::size_t index) const override;
+
+    private:
+        std::vector<std::string> paths_;
+        std::vector<std::size_t> sizes_;
+    };
+
+    // Blocks of a BlockStore, by height from firstHeight up
+    class BlockStoreSource : public ReindexSource {
+    public:
+        explicit BlockStoreSource(const BlockStore& blockStore, uint32_t firstHeight = 0);
+
+        std::size_t size() const override;
+        Block load(std::size_t index) const override;       // BlockStore::loadByHeight
+        std::size_t getEncodedSize(std::size_t index) const override;
+
+    private:
+        const BlockStore& blockStore_;
+        uint32_t firstHeight_;
+    };
+
+    struct ReindexStats {
+        uint64_t blocks = 0;            // Blocks connected by this run
+        uint64_t bytes = 0;             // Encoded bytes of those blocks
+        double seconds = 0;             // Wall time of this run so far
+        std::size_t nextIndex = 0;      // Source index of the next block to connect
+        std::string tipHash;            // Hash of the last connected block
+
+        double getBlocksPerSecond() const;
+        double getMegabytesPerSecond() const;
+    };
+
+    struct ReindexOptions {
+        unsigned int ioThreads = 4;                     // Threads loading (reading and decoding) blocks ahead
+        std::size_t prefetchBlocks = 512;               // Blocks loaded ahead of the connect stage
+        unsigned int signatureThreads = 0;              // Signature workers (0 = std::thread::hardware_concurrency())
+        const CheckpointIndex* checkpoints = nullptr;   // Enforce checkpoints
+        const HeaderIndex* headerChain = nullptr;       // Validated headers; with checkpoints, skip signatures on the chain to the last one
+        std::string progressFile;                       // Resume state; empty = always start from the first block
+        std::size_t progressInterval = 2000;            // Blocks connected between two progress saves
+        std::function<void()> flush;                    // Makes the connected state durable before a progress save
+                                                        // (blocks after the last save are connected again on resume)
+        std::function<void(const ReindexStats&)> onProgress;    // Called after each progress save
+    };
+
+    struct ReindexResult {
+        ReindexStats stats;
+        bool complete = false;                          // Every block of the source is connected
+        std::optional<std::size_t> failedIndex;         // Source index of the first block that failed
+        PipelineStatus failedStatus = PipelineStatus::Skipped;
+        std::string error;
+    };
+
+    // Rebuilds chain state from stored blocks: I/O threads load blocks ahead of time, a BlockPipeline checks
+    // Merkle roots and signatures in parallel, and blocks are connected strictly in order. Progress is saved
+    // every progressInterval blocks, so an interrupted reindex resumes where it stopped.
+    class ChainReindexer {
+    public:
+        ChainReindexer(const SPHINXMerkleBlock::SPHINXPubKey& publicKey, const ReindexOptions& options = ReindexOptions());
+
+        // Stops at the first invalid block or connect failure (reported in the result, not thrown).
+        // Throws std::runtime_error if the progress file does not match the source.
+        ReindexResult run(const ReindexSource& source, const BlockPipeline::ConnectFunction& connect);
+
+    private:
+        struct Progress {
+            std::size_t nextIndex = 0;
+            std::string tipHash;
+        };
+
+        std::optional<Progress> loadProgress() const;
+        void saveProgress(const Progress& progress) const;
+
+        SPHINXMerkleBlock::SPHINXPubKey publicKey_;
+        ReindexOptions options_;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXCHAINREINDEXER_HPP
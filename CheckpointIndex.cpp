@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the CheckpointIndex class, the indexed form of a Block's checkpointBlocks list.
+
+// Lookups:
+    // Checkpoint hashes are kept as raw digests in a hash set, so "is this a checkpoint" is one hash lookup
+    // instead of a scan of string compares. Checkpoints with a known height are also kept in a vector sorted
+    // by height, so the checkpoint at or below a height is a binary search.
+
+// Fast sync:
+    // getAssumedValidChain() walks the header index back from the last checkpoint through previousHash and
+    // returns the hashes it passes. Given that set (the headerChain option), verifyBlocks and BlockPipeline skip
+    // the SPHINCS+ signature check of a block only if its hash is on that chain (assumevalid-style), still
+    // check its Merkle root, and reject a block whose hash contradicts the checkpoint at its height. A block
+    // that is merely low enough (isCovered) but off the chain is verified in full. The header index is expected
+    // to hold headers already checked by validateHeaders (headers-first sync).
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "CheckpointIndex.hpp"
+#include "Block.hpp"
+#include "HeaderIndex.hpp"
+
+
+namespace SPHINXBlock {
+    CheckpointIndex::CheckpointIndex(const std::vector<Checkpoint>& checkpoints) {
+        byHeight_.reserve(checkpoints.size());
+        hashes_.reserve(checkpoints.size());
+        for (const Checkpoint& checkpoint : checkpoints) {
+            add(checkpoint);
+        }
+    }
+
+    CheckpointIndex::CheckpointIndex(const std::vector<std::string>& checkpointBlocks, const HeaderIndex& headers) {
+        hashes_.reserve(checkpointBlocks.size());
+        for (const std::string& blockHash : checkpointBlocks) {
+            const Digest digest = decodeDigest(blockHash);
+            if (std::optional<std::size_t> position = headers.findByHash(digest)) {
+                add(Checkpoint{headers.getHeader(*position).blockHeight, blockHash});
+            } else {
+                hashes_.insert(digest);
+            }
+        }
+    }
+
+    void CheckpointIndex::add(const Checkpoint& checkpoint) {
+        const Entry entry{checkpoint.blockHeight, decodeDigest(checkpoint.blockHash)};
+
+        auto it = std::lower_bound(byHeight_.begin(), byHeight_.end(), entry.blockHeight,
+                                   [](const Entry& existing, uint32_t height) { return existing.blockHeight < height; });
+        if (it != byHeight_.end() && it->blockHeight == entry.blockHeight) {
+            if (it->blockHash != entry.blockHash) {
+                throw std::invalid_argument("Conflicting checkpoints at height " + std::to_string(entry.blockHeight));
+            }
+            return;
+        }
+        byHeight_.insert(it, entry);
+        hashes_.insert(entry.blockHash);
+    }
+
+    bool CheckpointIndex::contains(const std::string& blockHash) const {
+        return contains(decodeDigest(blockHash));
+    }
+
+    bool CheckpointIndex::contains(const Digest& blockHash) const {
+        return hashes_.count(blockHash) != 0;
+    }
+
+    Checkpoint CheckpointIndex::toCheckpoint(const Entry& entry) {
+        return Checkpoint{entry.blockHeight, encodeDigest(entry.blockHash)};
+    }
+
+    std::optional<Checkpoint> CheckpointIndex::findByHeight(uint32_t blockHeight) const {
+        auto it = std::lower_bound(byHeight_.begin(), byHeight_.end(), blockHeight,
+                                   [](const Entry& entry, uint32_t height) { return entry.blockHeight < height; });
+        if (it == byHeight_.end() || it->blockHeight != blockHeight) {
+            return std::nullopt;
+        }
+        return toCheckpoint(*it);
+    }
+
+    std::optional<Checkpoint> CheckpointIndex::findAtOrBelow(uint32_t blockHeight) const {
+        auto it = std::upper_bound(byHeight_.begin(), byHeight_.end(), blockHeight,
+                                   [](uint32_t height, const Entry& entry) { return height < entry.blockHeight; });
+        if (it == byHeight_.begin()) {
+            return std::nullopt;
+        }
+        return toCheckpoint(*std::prev(it));
+    }
+
+    std::optional<Checkpoint> CheckpointIndex::getLastCheckpoint() const {
+        if (byHeight_.empty()) {
+            return std::nullopt;
+        }
+        return toCheckpoint(byHeight_.back());
+    }
+
+    bool CheckpointIndex::isCovered(uint32_t blockHeight) const {
+        return !byHeight_.empty() && blockHeight <= byHeight_.back().blockHeight;
+    }
+
+    std::unordered_set<Digest, DigestHasher> CheckpointIndex::getAssumedValidChain(const HeaderIndex& headers) const {
+        std::unordered_set<Digest, DigestHasher> chain;
+        if (byHeight_.empty()) {
+            return chain;
+        }
+
+        std::optional<std::size_t> position = headers.findByHash(byHeight_.back().blockHash);
+        if (!position || headers.getHeader(*position).blockHeight != byHeight_.back().blockHeight) {
+            return chain;
+        }
+        chain.reserve(byHeight_.back().blockHeight + 1);
+        while (position) {
+            const BlockHeader& header = headers.getHeader(*position);
+            chain.insert(headers.getHash(*position));
+            if (header.blockHeight == 0) {
+                break;
+            }
+            // Stop at a gap or at a parent whose height does not precede the child's
+            std::optional<std::size_t> parent = headers.findByHash(header.previousHash);
+            if (parent && headers.getHeader(*parent).blockHeight + 1 != header.blockHeight) {
+                parent.reset();
+            }
+            position = parent;
+        }
+        return chain;
+    }
+
+    bool CheckpointIndex::matches(uint32_t blockHeight, const std::string& blockHash) const {
+        auto it = std::lower_bound(byHeight_.begin(), byHeight_.end(), blockHeight,
+                                   [](const Entry& entry, uint32_t height) { return entry.blockHeight < height; });
+        return it == byHeight_.end() || it->blockHeight != blockHeight || it->blockHash == decodeDigest(blockHash);
+    }
+
+    bool CheckpointIndex::matches(const Block& block) const {
+        return matches(block.getBlockHeight(), block.getBlockHash());
+    }
+
+    std::size_t CheckpointIndex::size() const {
+        return hashes_.size();
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXCHECKPOINTINDEX_HPP
+#define SPHINXCHECKPOINTINDEX_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "BlockHeader.hpp"
+
+
+namespace SPHINXBlock {
+    class Block;       // Forward declaration of the Block class
+    class HeaderIndex; // Forward declaration of the HeaderIndex class
+
+    struct Checkpoint {
+        uint32_t blockHeight = 0;
+        std::string blockHash;
+    };
+
+    // Checkpoint lookups: O(1) membership by hash, O(log n) lookups by height
+    class CheckpointIndex {
+    public:
+        CheckpointIndex() = default;
+        explicit CheckpointIndex(const std::vector<Checkpoint>& checkpoints);
+
+        // Index a plain checkpoint hash list (the Block checkpointBlocks list). Heights are taken from the header
+        // index; hashes it does not know are kept for membership tests only.
+        CheckpointIndex(const std::vector<std::string>& checkpointBlocks, const HeaderIndex& headers);
+
+        // Add one checkpoint; throws std::invalid_argument if the height already has a different hash
+        void add(const Checkpoint& checkpoint);
+
+        bool contains(const std::string& blockHash) const;
+        bool contains(const Digest& blockHash) const;
+
+        // The checkpoint at exactly this height, or the nearest one at or below it
+        std::optional<Checkpoint> findByHeight(uint32_t blockHeight) const;
+        std::optional<Checkpoint> findAtOrBelow(uint32_t blockHeight) const;
+
+        // The highest checkpoint with a known height
+        std::optional<Checkpoint> getLastCheckpoint() const;
+
+        // True if the block is at or below the last checkpoint (it may be on the chain that skips signatures)
+        bool isCovered(uint32_t blockHeight) const;
+
+        // Hashes of the chain that ends at the last checkpoint, walked back through previousHash in the header
+        // index. Only these blocks may skip their signature check; empty if the index lacks that checkpoint.
+        std::unordered_set<Digest, DigestHasher> getAssumedValidChain(const HeaderIndex& headers) const;
+
+        // False if a checkpoint pins this height to a different hash
+        bool matches(uint32_t blockHeight, const std::string& blockHash) const;
+        bool matches(const Block& block) const;
+
+        std::size_t size() const;
+
+    private:
+        struct Entry {
+            uint32_t blockHeight;
+            Digest blockHash;
+        };
+
+        static Checkpoint toCheckpoint(const Entry& entry);
+
+        std::vector<Entry> byHeight_;                               // Sorted by height
+        std::unordered_set<Digest, DigestHasher> hashes_;           // Every checkpoint hash, with or without a height
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXCHECKPOINTINDEX_HPP
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines SPHINX_256_xN, the batch hashing entry point used by the Merkle tree and the miner.
+
+// Dispatch:
+    // The SPHINX_256 compression function lives in the Hash module, so the wide (AVX2 / AVX-512) kernels are
+    // registered from there through registerBatchKernel(). On first use the dispatcher detects the CPU with
+    // __builtin_cpu_supports and picks the widest registered kernel the CPU can run. When none is registered
+    // (or the CPU is too old) every message goes through the scalar SPHINX_256 fallback.
+    // Each selection is a new immutable Dispatch published through an atomic pointer. Hashing threads may
+    // still be reading an older one, so superseded selections are kept alive rather than rewritten or freed
+    // (registration happens a handful of times per process).
+
+// Batching:
+    // Kernels take exactly `lanes` messages of identical length, which is what Merkle levels (pairs of
+    // digests) and mining (midstate + nonce) produce. SPHINX_256_xN feeds them runs of equal-length
+    // messages and hashes any leftovers with the scalar path, so callers never need to pad or sort.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "HashBatch.hpp"
+#include "Hash.hpp"
+
+
+namespace SPHINXHash {
+    namespace {
+        struct KernelSlot {
+            std::size_t lanes = 1;
+            BatchKernel kernel = nullptr;
+        };
+
+        struct Dispatch {
+            BatchIsa isa = BatchIsa::Scalar;
+            std::size_t lanes = 1;
+            BatchKernel kernel = nullptr;
+        };
+
+        std::mutex registryMutex;
+        KernelSlot registry[3];                  // Indexed by BatchIsa
+        std::vector<std::unique_ptr<const Dispatch>> selections;  // Every Dispatch ever published (never freed)
+        std::atomic<const Dispatch*> active(nullptr);
+
+        void scalarKernel(const std::string* inputs, std::string* outputs, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i) {
+                outputs[i] = SPHINX_256(inputs[i]);
+            }
+        }
+
+        bool cpuSupports(BatchIsa isa) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            switch (isa) {
+                case BatchIsa::AVX512:
+                    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+                case BatchIsa::AVX2:
+                    return __builtin_cpu_supports("avx2");
+                case BatchIsa::Scalar:
+                    return true;
+            }
+            return false;
+#else
+            return isa == BatchIsa::Scalar;
+#endif
+        }
+
+        // Pick the widest registered kernel the CPU can run and publish it (caller holds registryMutex)
+        const Dispatch* selectKernel() {
+            Dispatch choice{BatchIsa::Scalar, 1, scalarKernel};
+            for (BatchIsa isa : {BatchIsa::AVX512, BatchIsa::AVX2}) {
+                const KernelSlot& slot = registry[static_cast<int>(isa)];
+                if (slot.kernel != nullptr && cpuSupports(isa)) {
+                    choice = Dispatch{isa, slot.lanes, slot.kernel};
+                    break;
+                }
+            }
+            selections.push_back(std::make_unique<const Dispatch>(choice));
+            active.store(selections.back().get(), std::memory_order_release);
+            return selections.back().get();
+        }
+
+        const Dispatch& dispatch() {
+            const Dispatch* current = active.load(std::memory_order_acquire);
+            if (current == nullptr) {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                current = active.load(std::memory_order_acquire); // Another thread may have selected meanwhile
+                if (current == nullptr) {
+                    current = selectKernel();
+                }
+            }
+            return *current;
+        }
+    }
+
+    BatchIsa detectBatchIsa() {
+        if (cpuSupports(BatchIsa::AVX512)) {
+            return BatchIsa::AVX512;
+        }
+        if (cpuSupports(BatchIsa::AVX2)) {
+            return BatchIsa::AVX2;
+        }
+        return BatchIsa::Scalar;
+    }
+
+    void registerBatchKernel(BatchIsa isa, std::size_t lanes, BatchKernel kernel) {
+        if (isa == BatchIsa::Scalar || lanes < 2 || kernel == nullptr) {
+            throw std::invalid_argument("A batch kernel needs a SIMD instruction set and at least two lanes");
+        }
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry[static_cast<int>(isa)] = KernelSlot{lanes, kernel};
+        selectKernel();
+    }
+
+    BatchIsa getActiveBatchIsa() {
+        return dispatch().isa;
+    }
+
+    std::size_t getBatchLanes() {
+        return dispatch().lanes;
+    }
+
+    void SPHINX_256_xN(const std::string* inputs, std::string* outputs, std::size_t count) {
+        const Dispatch& kernel = dispatch();
+        if (kernel.lanes == 1) {
+            scalarKernel(inputs, outputs, count);
+            return;
+        }
+
+        std::size_t i = 0;
+        while (i + kernel.lanes <= count) {
+            // Only a full run of equal-length messages can share one kernel pass
+            std::size_t run = 1;
+            while (run < kernel.lanes && inputs[i + run].size() == inputs[i].size()) {
+                ++run;
+            }
+            if (run == kernel.lanes) {
+                kernel.kernel(inputs + i, outputs + i, kernel.lanes);
+                i += kernel.lanes;
+            } else {
+                scalarKernel(inputs + i, outputs + i, run);
+                i += run;
+            }
+        }
+        scalarKernel(inputs + i, outputs + i, count - i);
+    }
+
+    void SPHINX_256_xN(std::span<const std::string> inputs, std::span<std::string> outputs) {
+        if (outputs.size() < inputs.size()) {
+            throw std::invalid_argument("SPHINX_256_xN needs one output per input");
+        }
+        SPHINX_256_xN(inputs.data(), outputs.data(), inputs.size());
+    }
+} // namespace SPHINXHash
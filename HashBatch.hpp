@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXHASHBATCH_HPP
+#define SPHINXHASHBATCH_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+
+namespace SPHINXHash {
+    // Instruction sets a multi-buffer kernel can be built for
+    enum class BatchIsa {
+        Scalar,  // One message at a time through SPHINX_256
+        AVX2,    // 8 x 32-bit lanes
+        AVX512   // 16 x 32-bit lanes
+    };
+
+    // Multi-buffer kernel: hashes `count` (== its lane count) messages of identical length in one pass
+    using BatchKernel = void (*)(const std::string* inputs, std::string* outputs, std::size_t count);
+
+    // Hash many independent messages; runs of equal-length messages go through the widest available kernel
+    void SPHINX_256_xN(const std::string* inputs, std::string* outputs, std::size_t count);
+    void SPHINX_256_xN(std::span<const std::string> inputs, std::span<std::string> outputs);
+
+    // Register a multi-buffer kernel for an instruction set; it is used if the CPU supports that set
+    void registerBatchKernel(BatchIsa isa, std::size_t lanes, BatchKernel kernel);
+
+    // Returns the widest instruction set supported by the running CPU
+    BatchIsa detectBatchIsa();
+
+    // Returns the instruction set and lane count of the kernel SPHINX_256_xN currently dispatches to
+    BatchIsa getActiveBatchIsa();
+    std::size_t getBatchLanes();
+} // namespace SPHINXHash
+
+#endif // SPHINXHASHBATCH_HPP
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the HeaderIndex class, an in-memory index of compact block headers.
+
+// Storage:
+    // Headers (88 bytes each) and their 32-byte hashes are kept in two contiguous vectors, so scanning millions of
+    // headers walks memory sequentially and never touches a transaction. Positions are stable until clear().
+
+// Lookups:
+    // Height and hash maps point at positions. A later header at the same height (a competing branch) takes over
+    // the height entry; both stay reachable by hash.
+
+// Sources:
+    // Headers come from a Block (getHeader), from a BlockHeader whose hash is already known, or straight from a
+    // BlockStore record through readBlockHeader, which skips the block body.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "HeaderIndex.hpp"
+#include "Block.hpp"
+#include "BlockStore.hpp"
+
+
+namespace SPHINXBlock {
+    void HeaderIndex::reserve(std::size_t headerCount) {
+        headers_.reserve(headerCount);
+        hashes_.reserve(headerCount);
+        byHeight_.reserve(headerCount);
+        byHash_.reserve(headerCount);
+    }
+
+    std::size_t HeaderIndex::add(const BlockHeader& header) {
+        return add(header, decodeDigest(header.calculateHash()));
+    }
+
+    std::size_t HeaderIndex::add(const BlockHeader& header, const Digest& blockHash) {
+        const std::size_t position = headers_.size();
+        headers_.push_back(header);
+        hashes_.push_back(blockHash);
+        byHeight_[header.blockHeight] = position;
+        byHash_[blockHash] = position;
+        return position;
+    }
+
+    std::size_t HeaderIndex::add(const Block& block) {
+        return add(block.getHeader(), decodeDigest(block.getBlockHash())); // Reuse the block's memoized hash
+    }
+
+    std::size_t HeaderIndex::addFromStore(const BlockStore& blockStore, uint32_t firstHeight, uint32_t lastHeight) {
+        std::size_t added = 0;
+        for (uint64_t height = firstHeight; height <= lastHeight; ++height) {
+            if (std::optional<BlockHeader> header = blockStore.readHeaderByHeight(static_cast<uint32_t>(height))) {
+                add(*header);
+                ++added;
+            }
+        }
+        return added;
+    }
+
+    std::optional<std::size_t> HeaderIndex::findByHeight(uint32_t blockHeight) const {
+        auto it = byHeight_.find(blockHeight);
+        if (it == byHeight_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::optional<std::size_t> HeaderIndex::findByHash(const std::string& blockHash) const {
+        return findByHash(decodeDigest(blockHash));
+    }
+
+    std::optional<std::size_t> HeaderIndex::findByHash(const Digest& blockHash) const {
+        auto it = byHash_.find(blockHash);
+        if (it == byHash_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    const BlockHeader& HeaderIndex::getHeader(std::size_t position) const {
+        return headers_.at(position);
+    }
+
+    const Digest& HeaderIndex::getHash(std::size_t position) const {
+        return hashes_.at(position);
+    }
+
+    std::span<const BlockHeader> HeaderIndex::getHeaders() const {
+        return headers_;
+    }
+
+    std::span<const Digest> HeaderIndex::getHashes() const {
+        return hashes_;
+    }
+
+    std::size_t HeaderIndex::size() const {
+        return headers_.size();
+    }
+
+    void HeaderIndex::clear() {
+        headers_.clear();
+        hashes_.clear();
+        byHeight_.clear();
+        byHash_.clear();
+    }
+} // namespace SPHINXBlock
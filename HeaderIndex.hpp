@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXHEADERINDEX_HPP
+#define SPHINXHEADERINDEX_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BlockHeader.hpp"
+
+
+namespace SPHINXBlock {
+    class Block;      // Forward declaration of the Block class
+    class BlockStore; // Forward declaration of the BlockStore class
+
+    // Contiguous header array with height and hash lookups, for light clients and headers-first sync.
+    // Not synchronized: guard it externally if it is written while other threads read it.
+    class HeaderIndex {
+    public:
+        void reserve(std::size_t headerCount);
+
+        // Append a header (hashing it, unless the hash is given) and return its position
+        std::size_t add(const BlockHeader& header);
+        std::size_t add(const BlockHeader& header, const Digest& blockHash);
+        std::size_t add(const Block& block);
+
+        // Append the header of every block stored at the given heights
+        std::size_t addFromStore(const BlockStore& blockStore, uint32_t firstHeight, uint32_t lastHeight);
+
+        std::optional<std::size_t> findByHeight(uint32_t blockHeight) const;
+        std::optional<std::size_t> findByHash(const std::string& blockHash) const;
+        std::optional<std::size_t> findByHash(const Digest& blockHash) const;
+
+        const BlockHeader& getHeader(std::size_t position) const;
+        const Digest& getHash(std::size_t position) const;
+
+        // All headers and their hashes, in insertion order
+        std::span<const BlockHeader> getHeaders() const;
+        std::span<const Digest> getHashes() const;
+
+        std::size_t size() const;
+        void clear();
+
+    private:
+        std::vector<BlockHeader> headers_;
+        std::vector<Digest> hashes_;    // hashes_[i] is the block hash of headers_[i]
+        std::unordered_map<uint32_t, std::size_t> byHeight_;
+        std::unordered_map<Digest, std::size_t, DigestHasher> byHash_;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXHEADERINDEX_HPP
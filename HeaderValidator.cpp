@@ -0,0 +1,167 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the header pre-validation pass that runs before any Merkle or signature work.
+
+// Checks:
+    // Timestamp: at most maxTimestampOffset (Block::MAX_TIMESTAMP_OFFSET) seconds ahead of the reference time,
+    //     and not earlier than the parent's timestamp.
+    // Difficulty: at least minimumDifficulty (1 by default, so a header cannot skip proof of work by declaring 0)
+    //     and equal to expectedDifficulty when one is set.
+    // Linkage: previousHash is the parent's block hash and the height is the parent's height + 1. Only
+    //     validateHeaders checks it; checkHeader (used by BlockPipeline) sees one header without its parent.
+    // Proof of work: the block hash starts with `difficulty` zero hex digits (SPHINXMiner::meetsDifficulty).
+
+// Batch passes:
+    // 1. The field checks run as one branch-free loop over the batch, producing a status code per header, so
+    //    spam with bad timestamps or difficulty is rejected before a single hash is computed.
+    // 2. The headers up to the first failure are hashed in chunks through SPHINX_256_xN, once for the 80-byte
+    //    prefixes and once for the 36-byte midstate tails, so equal-length messages share SIMD lanes.
+    // 3. Linkage and proof of work are checked against those hashes in order.
+    // Headers after the first failure build on an invalid block and are reported as InvalidParent.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "HeaderValidator.hpp"
+#include "Block.hpp"
+#include "HashBatch.hpp"
+#include "Miner.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        constexpr std::size_t HASH_CHUNK = 1024; // Headers hashed per SPHINX_256_xN round (bounds the scratch buffers)
+
+        int64_t latestTimestamp(const HeaderValidationOptions& options) {
+            const int64_t now = options.now != 0 ? static_cast<int64_t>(options.now) : static_cast<int64_t>(std::time(nullptr));
+            const int64_t offset = options.maxTimestampOffset != 0 ? options.maxTimestampOffset : static_cast<int64_t>(Block::MAX_TIMESTAMP_OFFSET);
+            return now + offset;
+        }
+
+        // The parent-independent field checks, branch-free so the batch loop vectorizes
+        HeaderStatus checkFields(const BlockHeader& header, int64_t latest, const HeaderValidationOptions& options) {
+            const bool tooNew = header.timestamp > latest;
+            const bool wrongDifficulty = header.difficulty < options.minimumDifficulty ||
+                                         (options.expectedDifficulty != 0 && header.difficulty != options.expectedDifficulty);
+            return tooNew ? HeaderStatus::TimestampTooNew
+                 : wrongDifficulty ? HeaderStatus::DifficultyMismatch
+                 : HeaderStatus::Valid;
+        }
+
+        // Hash headers[begin, end) in two batched rounds (prefix, then midstate || nonce)
+        void hashHeaders(std::span<const BlockHeader> headers, std::size_t begin, std::size_t end, std::vector<std::string>& blockHashes) {
+            std::vector<std::string> prefixes(end - begin);
+            std::vector<std::string> midstates(end - begin);
+            std::vector<HeaderBytes> encoded(end - begin);
+            for (std::size_t i = begin; i < end; ++i) {
+                encoded[i - begin] = headers[i].toBytes();
+                prefixes[i - begin].assign(reinterpret_cast<const char*>(encoded[i - begin].data()), HEADER_NONCE_OFFSET);
+            }
+            SPHINXHash::SPHINX_256_xN(prefixes.data(), midstates.data(), prefixes.size());
+
+            std::vector<std::string>& tails = prefixes; // Reuse the buffers for the second round
+            for (std::size_t i = 0; i < tails.size(); ++i) {
+                const Digest inner = decodeDigest(midstates[i]);
+                tails[i].assign(reinterpret_cast<const char*>(inner.data()), inner.size());
+                tails[i].append(reinterpret_cast<const char*>(encoded[i].data()) + HEADER_NONCE_OFFSET, HEADER_SIZE - HEADER_NONCE_OFFSET);
+            }
+            SPHINXHash::SPHINX_256_xN(tails.data(), blockHashes.data() + begin, tails.size());
+        }
+    }
+
+    HeaderChainTip HeaderChainTip::fromHeader(const BlockHeader& header) {
+        HeaderChainTip tip;
+        tip.blockHash = decodeDigest(header.calculateHash());
+        tip.blockHeight = header.blockHeight;
+        tip.timestamp = header.timestamp;
+        return tip;
+    }
+
+    std::vector<HeaderStatus> validateHeaders(std::span<const BlockHeader> headers, const HeaderChainTip& tip,
+                                              const HeaderValidationOptions& options, std::vector<Digest>* blockHashes) {
+        const std::size_t count = headers.size();
+        std::vector<HeaderStatus> statuses(count, HeaderStatus::Valid);
+        if (blockHashes != nullptr) {
+            blockHashes->clear();
+        }
+        if (count == 0) {
+            return statuses;
+        }
+
+        // Pass 1: field checks over the whole batch
+        const int64_t latest = latestTimestamp(options);
+        for (std::size_t i = 0; i < count; ++i) {
+            const int64_t parentTimestamp = i == 0 ? tip.timestamp : headers[i - 1].timestamp;
+            const uint32_t parentHeight = i == 0 ? tip.blockHeight : headers[i - 1].blockHeight;
+            const HeaderStatus fields = checkFields(headers[i], latest, options);
+            const bool tooOld = headers[i].timestamp < parentTimestamp;
+            const bool wrongHeight = headers[i].blockHeight != parentHeight + 1;
+            statuses[i] = fields != HeaderStatus::Valid ? fields
+                        : tooOld ? HeaderStatus::TimestampTooOld
+                        : wrongHeight ? HeaderStatus::BrokenLink
+                        : HeaderStatus::Valid;
+        }
+        std::size_t firstInvalid = static_cast<std::size_t>(
+            std::find_if(statuses.begin(), statuses.end(), [](HeaderStatus status) { return status != HeaderStatus::Valid; }) - statuses.begin());
+
+        // Passes 2 and 3: hash the surviving prefix chunk by chunk, then check linkage and proof of work
+        std::vector<std::string> hashes(firstInvalid);
+        std::size_t checked = 0;
+        while (checked < firstInvalid) {
+            const std::size_t end = std::min(firstInvalid, checked + HASH_CHUNK);
+            hashHeaders(headers, checked, end, hashes);
+
+            for (std::size_t i = checked; i < end; ++i) {
+                const Digest parentHash = i == 0 ? tip.blockHash : decodeDigest(hashes[i - 1]);
+                if (headers[i].previousHash != parentHash) {
+                    statuses[i] = HeaderStatus::BrokenLink;
+                } else if (!SPHINXMiner::meetsDifficulty(hashes[i], headers[i].difficulty)) {
+                    statuses[i] = HeaderStatus::InsufficientWork;
+                } else {
+                    continue;
+                }
+                firstInvalid = i;
+                break;
+            }
+            checked = std::min(end, firstInvalid);
+        }
+
+        if (firstInvalid < count) {
+            std::fill(statuses.begin() + static_cast<std::ptrdiff_t>(firstInvalid) + 1, statuses.end(), HeaderStatus::InvalidParent);
+        }
+        if (blockHashes != nullptr) {
+            blockHashes->reserve(firstInvalid);
+            for (std::size_t i = 0; i < firstInvalid; ++i) {
+                blockHashes->push_back(decodeDigest(hashes[i]));
+            }
+        }
+        return statuses;
+    }
+
+    HeaderStatus checkHeader(const BlockHeader& header, const HeaderValidationOptions& options) {
+        const HeaderStatus fields = checkFields(header, latestTimestamp(options), options);
+        if (fields != HeaderStatus::Valid) {
+            return fields;
+        }
+        return SPHINXMiner::meetsDifficulty(header.calculateHash(), header.difficulty) ? HeaderStatus::Valid : HeaderStatus::InsufficientWork;
+    }
+} // namespace SPHINXBlock
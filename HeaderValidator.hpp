@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXHEADERVALIDATOR_HPP
+#define SPHINXHEADERVALIDATOR_HPP
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <vector>
+
+#include "BlockHeader.hpp"
+
+
+namespace SPHINXBlock {
+    // Outcome of the header pre-validation of one block
+    enum class HeaderStatus {
+        Valid,              // Passes every header check
+        TimestampTooNew,    // More than maxTimestampOffset seconds ahead of the reference time
+        TimestampTooOld,    // Earlier than the timestamp of its parent
+        DifficultyMismatch, // Declares a difficulty below minimumDifficulty or other than the one the chain requires
+        BrokenLink,         // previousHash or height does not follow on from its parent
+        InsufficientWork,   // The block hash does not meet the declared difficulty
+        InvalidParent       // An earlier header in the batch failed
+    };
+
+    struct HeaderValidationOptions {
+        std::time_t now = 0;                // Reference time for the timestamp check (0 = std::time(nullptr))
+        int64_t maxTimestampOffset = 0;     // Allowed drift into the future (0 = Block::MAX_TIMESTAMP_OFFSET)
+        uint32_t expectedDifficulty = 0;    // Difficulty every header must declare (0 = any, but it must be met)
+        uint32_t minimumDifficulty = 1;     // Lowest difficulty a header may declare (0 admits headers with no proof of work)
+    };
+
+    // The block a batch of headers builds on
+    struct HeaderChainTip {
+        Digest blockHash{};
+        uint32_t blockHeight = 0;
+        int64_t timestamp = 0;
+
+        static HeaderChainTip fromHeader(const BlockHeader& header);
+    };
+
+    // Check a run of consecutive headers on top of the tip, from the headers alone: timestamps, difficulty,
+    // previous hash and height linkage, and proof of work. Returns one status per header; everything after the
+    // first invalid header is InvalidParent. With blockHashes set, the hashes of the valid headers are returned
+    // (ready for HeaderIndex::add).
+    std::vector<HeaderStatus> validateHeaders(std::span<const BlockHeader> headers, const HeaderChainTip& tip,
+                                              const HeaderValidationOptions& options = HeaderValidationOptions(),
+                                              std::vector<Digest>* blockHashes = nullptr);
+
+    // The checks that need no parent: timestamp not too new, difficulty and proof of work. Linkage (previousHash
+    // and height) is only checked by validateHeaders, so a header that passes here may still not extend the chain.
+    HeaderStatus checkHeader(const BlockHeader& header, const HeaderValidationOptions& options = HeaderValidationOptions());
+} // namespace SPHINXBlock
+
+#endif // SPHINXHEADERVALIDATOR_HPP
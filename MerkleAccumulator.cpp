@@ -0,0 +1,312 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the MerkleAccumulator class, the incremental Merkle tree kept by every Block.
+
+// Tree shape:
+    // Leaves are SPHINX_256(0x00 + transaction) and inner nodes are SPHINX_256(0x01 + left + right). The tag
+    // bytes keep the two domains apart: without them a block whose single transaction is the concatenation of
+    // two leaf hashes would share the root of the block holding those two transactions. An empty tree has the
+    // root SPHINX_256(0x02), which no leaf or node preimage can produce.
+    // A level with an odd number of nodes promotes its last node to the next level unhashed. Pairing it with
+    // itself instead would give [a, b, c] and [a, b, c, c] the same root, so a block with a duplicated trailing
+    // transaction would pass under the original hash and signature. All levels are cached, levels_[0] being the
+    // leaves and levels_.back() the single root.
+
+// Incremental updates:
+    // append() pushes one leaf and walks its path upwards, recomputing exactly one parent per level and
+    // creating a new top level when the old top gains a second node. Adding a transaction therefore costs
+    // O(log n) hashes instead of rebuilding the whole tree.
+
+// Proofs:
+    // getProof() collects the sibling of the leaf's ancestor at each level where it has one, and records the
+    // leaf count. verifyProof() derives from the leaf count which levels promote the ancestor unhashed, and
+    // replays the hashes from the transaction up to the root.
+
+// Full rebuilds:
+    // rebuild() hashes all leaves, then all pairs of each level, through the SPHINX_256_xN batch interface so
+    // the equal-sized pair messages can go through a multi-lane SIMD kernel.
+
+// Parallel rebuilds:
+    // A level with at least parallelThreshold nodes is cut into chunks that the calling thread and the pool
+    // workers claim from a shared atomic counter, so a slow or busy worker simply takes fewer chunks. Each
+    // chunk writes its hashes into its own slice of the level, and levels are still built one after the
+    // other, so the root is bit-identical to the serial build. Smaller levels (and small blocks) skip the pool.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MerkleAccumulator.hpp"
+#include "TransactionArena.hpp"
+#include "ThreadPool.hpp"
+#include "Hash.hpp"
+#include "HashBatch.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        // Domain tags prefixed to every preimage (see "Tree shape")
+        constexpr char LEAF_TAG = '\x00';
+        constexpr char NODE_TAG = '\x01';
+        constexpr char EMPTY_TAG = '\x02';
+
+        std::string leafPreimage(std::string_view transaction) {
+            std::string preimage;
+            preimage.reserve(transaction.size() + 1);
+            preimage.push_back(LEAF_TAG);
+            preimage.append(transaction);
+            return preimage;
+        }
+
+        std::string nodePreimage(const std::string& left, const std::string& right) {
+            std::string preimage;
+            preimage.reserve(left.size() + right.size() + 1);
+            preimage.push_back(NODE_TAG);
+            preimage.append(left);
+            preimage.append(right);
+            return preimage;
+        }
+
+        // Fewest nodes handed to a worker at once, so queueing stays cheap next to the hashing
+        constexpr std::size_t MIN_CHUNK_SIZE = 64;
+
+        // Chunks per worker; more than one lets faster threads pick up the slack of slower ones
+        constexpr std::size_t CHUNKS_PER_WORKER = 4;
+
+        ThreadPool& sharedMerklePool() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        // Fill `count` nodes through hashChunk(begin, end, nodes), in parallel chunks when the level is large
+        template <typename HashChunk>
+        std::vector<std::string> hashLevel(std::size_t count, const HashChunk& hashChunk, const MerkleBuildOptions& options) {
+            std::vector<std::string> nodes(count);
+            if (count < std::max<std::size_t>(options.parallelThreshold, 2)) {
+                hashChunk(0, count, nodes.data());
+                return nodes;
+            }
+
+            ThreadPool& pool = options.pool != nullptr ? *options.pool : sharedMerklePool();
+            const std::size_t workers = pool.getThreadCount();
+            const std::size_t chunkSize = std::max(MIN_CHUNK_SIZE, count / (workers * CHUNKS_PER_WORKER));
+            const std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+            std::atomic<std::size_t> nextChunk(0);
+            auto drain = [&]() {
+                for (std::size_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1)) {
+                    const std::size_t begin = chunk * chunkSize;
+                    hashChunk(begin, std::min(count, begin + chunkSize), nodes.data());
+                }
+            };
+
+            std::vector<std::future<void>> helpers;
+            const std::size_t helperCount = std::min(workers, chunkCount - 1);
+            helpers.reserve(helperCount);
+            for (std::size_t i = 0; i < helperCount; ++i) {
+                helpers.push_back(pool.submit(drain));
+            }
+
+            // The calling thread claims chunks too, so the build finishes even if the pool is busy elsewhere
+            std::exception_ptr error;
+            try {
+                drain();
+            } catch (...) {
+                error = std::current_exception();
+                nextChunk.store(chunkCount); // Let the helpers stop early
+            }
+
+            // Wait for every helper (they reference locals), then surface the first exception if any
+            for (std::future<void>& helper : helpers) {
+                helper.wait();
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            for (std::future<void>& helper : helpers) {
+                helper.get();
+            }
+            return nodes;
+        }
+    }
+
+    std::string MerkleAccumulator::hashLeaf(std::string_view transaction) {
+        return SPHINXHash::SPHINX_256(leafPreimage(transaction));
+    }
+
+    std::string MerkleAccumulator::hashNode(const std::string& left, const std::string& right) {
+        return SPHINXHash::SPHINX_256(nodePreimage(left, right));
+    }
+
+    void MerkleAccumulator::clear() {
+        levels_.clear();
+    }
+
+    void MerkleAccumulator::append(std::string_view transaction) {
+        if (levels_.empty()) {
+            levels_.emplace_back();
+        }
+        levels_[0].push_back(hashLeaf(transaction));
+        updatePath(levels_[0].size() - 1);
+    }
+
+    void MerkleAccumulator::replace(std::size_t leafIndex, std::string_view transaction) {
+        if (levels_.empty() || leafIndex >= levels_[0].size()) {
+            throw std::out_of_range("MerkleAccumulator::replace leaf index out of range");
+        }
+        levels_[0][leafIndex] = hashLeaf(transaction);
+        updatePath(leafIndex);
+    }
+
+    void MerkleAccumulator::updatePath(std::size_t index) {
+        for (std::size_t level = 0; levels_[level].size() > 1; ++level) {
+            const std::vector<std::string>& nodes = levels_[level];
+            const std::size_t parent = index / 2;
+            const std::string& left = nodes[2 * parent];
+            std::string parentHash = 2 * parent + 1 < nodes.size() ? hashNode(left, nodes[2 * parent + 1]) : left; // Odd node is promoted
+
+            if (levels_.size() == level + 1) {
+                levels_.emplace_back();
+            }
+            std::vector<std::string>& parents = levels_[level + 1];
+            if (parent < parents.size()) {
+                parents[parent] = std::move(parentHash);
+            } else {
+                parents.push_back(std::move(parentHash));
+            }
+            index = parent;
+        }
+    }
+
+    void MerkleAccumulator::rebuild(const std::vector<std::string>& transactions, const MerkleBuildOptions& options) {
+        levels_.clear();
+        if (transactions.empty()) {
+            return;
+        }
+
+        // Leaves and every level's pairs are independent messages, so each level is one batch hash
+        // Each chunk stages its own tagged leaf preimages for the batch call
+        levels_.push_back(hashLevel(transactions.size(), [&](std::size_t begin, std::size_t end, std::string* leaves) {
+            std::vector<std::string> staged;
+            staged.reserve(end - begin);
+            for (std::size_t i = begin; i < end; ++i) {
+                staged.push_back(leafPreimage(transactions[i]));
+            }
+            SPHINXHash::SPHINX_256_xN(staged.data(), leaves + begin, staged.size());
+        }, options));
+        buildInnerLevels(options);
+    }
+
+    void MerkleAccumulator::rebuild(const TransactionArena& transactions, const MerkleBuildOptions& options) {
+        levels_.clear();
+        if (transactions.empty()) {
+            return;
+        }
+
+        // SPHINX_256 takes std::string, so each chunk stages its own tagged leaves as strings for the batch call
+        levels_.push_back(hashLevel(transactions.size(), [&](std::size_t begin, std::size_t end, std::string* leaves) {
+            std::vector<std::string> staged;
+            staged.reserve(end - begin);
+            for (std::size_t i = begin; i < end; ++i) {
+                staged.push_back(leafPreimage(transactions[i]));
+            }
+            SPHINXHash::SPHINX_256_xN(staged.data(), leaves + begin, staged.size());
+        }, options));
+        buildInnerLevels(options);
+    }
+
+    void MerkleAccumulator::buildInnerLevels(const MerkleBuildOptions& options) {
+        while (levels_.back().size() > 1) {
+            const std::vector<std::string>& nodes = levels_.back();
+            std::vector<std::string> parents = hashLevel((nodes.size() + 1) / 2, [&](std::size_t begin, std::size_t end, std::string* outputs) {
+                const std::size_t pairedEnd = std::min(end, nodes.size() / 2);
+                std::vector<std::string> pairs;
+                pairs.reserve(end - begin);
+                for (std::size_t parent = begin; parent < pairedEnd; ++parent) {
+                    pairs.push_back(nodePreimage(nodes[2 * parent], nodes[2 * parent + 1]));
+                }
+                SPHINXHash::SPHINX_256_xN(pairs.data(), outputs + begin, pairs.size());
+                for (std::size_t parent = std::max(begin, pairedEnd); parent < end; ++parent) {
+                    outputs[parent] = nodes[2 * parent]; // Odd node is promoted
+                }
+            }, options);
+            levels_.push_back(std::move(parents));
+        }
+    }
+
+    std::string MerkleAccumulator::getRoot() const {
+        if (levels_.empty()) {
+            return SPHINXHash::SPHINX_256(std::string(1, EMPTY_TAG));
+        }
+        return levels_.back().front();
+    }
+
+    std::size_t MerkleAccumulator::getLeafCount() const {
+        return levels_.empty() ? 0 : levels_[0].size();
+    }
+
+    MerkleProof MerkleAccumulator::getProof(std::size_t leafIndex) const {
+        if (leafIndex >= getLeafCount()) {
+            throw std::out_of_range("No transaction at index " + std::to_string(leafIndex));
+        }
+
+        MerkleProof proof;
+        proof.leafIndex = leafIndex;
+        proof.leafCount = getLeafCount();
+
+        std::size_t index = leafIndex;
+        for (std::size_t level = 0; level + 1 < levels_.size(); ++level) {
+            const std::vector<std::string>& nodes = levels_[level];
+            const std::size_t sibling = index ^ 1;
+            if (sibling < nodes.size()) {
+                proof.siblings.push_back(nodes[sibling]);
+            }
+            index /= 2;
+        }
+        return proof;
+    }
+
+    bool MerkleAccumulator::verifyProof(std::string_view transaction, const MerkleProof& proof, const std::string& merkleRoot) {
+        if (proof.leafIndex >= proof.leafCount) {
+            return false;
+        }
+
+        std::string hash = hashLeaf(transaction);
+        std::size_t index = proof.leafIndex;
+        std::size_t levelSize = proof.leafCount;
+        std::size_t used = 0;
+
+        for (; levelSize > 1; levelSize = (levelSize + 1) / 2, index /= 2) {
+            if ((index ^ 1) >= levelSize) {
+                continue; // Promoted unhashed
+            }
+            if (used == proof.siblings.size()) {
+                return false;
+            }
+            const std::string& sibling = proof.siblings[used++];
+            hash = index % 2 == 0 ? hashNode(hash, sibling) : hashNode(sibling, hash);
+        }
+        return used == proof.siblings.size() && hash == merkleRoot;
+    }
+} // namespace SPHINXBlock
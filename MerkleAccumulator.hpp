@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXMERKLEACCUMULATOR_HPP
+#define SPHINXMERKLEACCUMULATOR_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace SPHINXBlock {
+    class TransactionArena; // Forward declaration of the TransactionArena class
+    class ThreadPool;       // Forward declaration of the ThreadPool class
+
+    // Smallest level (in nodes) that full rebuilds hash in parallel; smaller levels stay on the calling thread
+    constexpr std::size_t PARALLEL_MERKLE_THRESHOLD = 256;
+
+    // Inclusion proof for one transaction: the sibling hashes from the leaf level up to below the root
+    struct MerkleProof {
+        std::size_t leafIndex = 0;           // Position of the transaction in the block
+        std::size_t leafCount = 0;           // Number of transactions in the block (fixes the tree shape)
+        std::vector<std::string> siblings;   // Sibling hash at each level that has one, leaf level first
+    };
+
+    // Options controlling how a full rebuild spreads the hashing over worker threads
+    struct MerkleBuildOptions {
+        ThreadPool* pool = nullptr;                                 // Pool to hash on (nullptr = the shared Merkle pool)
+        std::size_t parallelThreshold = PARALLEL_MERKLE_THRESHOLD;  // Levels with fewer nodes are hashed serially
+    };
+
+    // Merkle tree that keeps every level cached so appending a transaction only rehashes one path
+    class MerkleAccumulator {
+    public:
+        // Remove all leaves
+        void clear();
+
+        // Add one transaction as the next leaf, rehashing only the path to the root (O(log n))
+        void append(std::string_view transaction);
+
+        // Replace one leaf, rehashing only the path to the root (O(log n))
+        void replace(std::size_t leafIndex, std::string_view transaction);
+
+        // Replace all leaves and rebuild every level (O(n)), hashing large levels in parallel
+        void rebuild(const std::vector<std::string>& transactions, const MerkleBuildOptions& options = MerkleBuildOptions());
+        void rebuild(const TransactionArena& transactions, const MerkleBuildOptions& options = MerkleBuildOptions());
+
+        // Returns the cached Merkle root (SPHINX_256 of the empty-tree tag byte for an empty tree)
+        std::string getRoot() const;
+
+        // Returns the number of leaves (transactions)
+        std::size_t getLeafCount() const;
+
+        // Build the inclusion proof for the transaction at the given index
+        MerkleProof getProof(std::size_t leafIndex) const;
+
+        // Check that a transaction and its proof lead to the given root
+        static bool verifyProof(std::string_view transaction, const MerkleProof& proof, const std::string& merkleRoot);
+
+        // Hashing rules shared by the tree and the proof verification (tagged: 0x00 leaves, 0x01 inner nodes)
+        static std::string hashLeaf(std::string_view transaction);
+        static std::string hashNode(const std::string& left, const std::string& right);
+
+    private:
+        // Recompute the parents of the node at the given index, level by level up to the root
+        void updatePath(std::size_t leafIndex);
+
+        // Hash the levels above levels_[0] up to the root
+        void buildInnerLevels(const MerkleBuildOptions& options);
+
+        std::vector<std::vector<std::string>> levels_;  // levels_[0] holds the leaf hashes, levels_.back() the root
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXMERKLEACCUMULATOR_HPP
@@ -0,0 +1,208 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the MiningEngine class, the multi-threaded nonce search behind Block::mineBlock.
+
+// Work distribution:
+    // The search space is the 32-bit nonce range for every timestamp from the block's timestamp up to
+    // timestamp + maxTimestampRolls. It is cut into fixed-size chunks of nonces, and workers pull the next
+    // chunk index from a shared atomic counter. Chunk k covers timestamp epoch k / chunksPerEpoch, so once
+    // the nonce range of one timestamp is exhausted the workers roll over to the next second (extra-nonce).
+    // Pulling chunks dynamically keeps all cores busy even when some threads are slower than others.
+    // Workers hash the binary header through HeaderHasher, re-absorbing the midstate only on a timestamp roll,
+    // and hash MINING_BATCH nonces per call so the batch kernel can fill its SIMD lanes.
+
+// Stopping:
+    // Workers stop when one of them finds a hash that meets the difficulty, when cancel() is called,
+    // when the caller's cancel flag becomes true, or when the time budget runs out. The stop conditions
+    // other than "found" are polled every few thousand hashes to keep the inner loop cheap.
+    // A cancel() is consumed by the search it stops: one that arrives before mine() starts stops that search
+    // as soon as it begins, and the request is cleared when the search returns.
+
+// Reporting:
+    // Every search reports the number of hashes tried, the elapsed time and the aggregate hash rate.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Miner.hpp"
+#include "Block.hpp"
+#include "BlockHeader.hpp"
+
+
+namespace SPHINXMiner {
+    namespace {
+        // How often (in hashes) workers poll the cancel flags and the deadline
+        constexpr uint64_t POLL_INTERVAL = 4096;
+
+        // Nonces hashed per SPHINX_256_xN call (a multiple of the AVX2 and AVX-512 lane counts)
+        constexpr std::size_t MINING_BATCH = 16;
+
+        constexpr uint64_t NONCE_SPACE = uint64_t(UINT32_MAX) + 1;
+    }
+
+    bool meetsDifficulty(const std::string& blockHash, uint32_t difficulty) {
+        if (blockHash.size() < difficulty) {
+            return false;
+        }
+        for (uint32_t i = 0; i < difficulty; ++i) {
+            if (blockHash[i] != '0') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    MiningEngine::MiningEngine(const MiningOptions& options)
+        : options_(options), cancelled_(false), lastHashRate_(0.0) {
+        if (options_.chunkSize == 0) {
+            options_.chunkSize = 1;
+        }
+    }
+
+    void MiningEngine::cancel() {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    double MiningEngine::getLastHashRate() const {
+        return lastHashRate_.load(std::memory_order_relaxed);
+    }
+
+    MiningResult MiningEngine::mine(const SPHINXBlock::Block& block, uint32_t difficulty) {
+        unsigned int threadCount = options_.threadCount;
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        const uint64_t chunkSize = options_.chunkSize;
+        const uint64_t chunksPerEpoch = (NONCE_SPACE + chunkSize - 1) / chunkSize;
+        const uint64_t totalChunks = chunksPerEpoch * (uint64_t(options_.maxTimestampRolls) + 1);
+        const std::time_t baseTimestamp = block.getTimestamp();
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool hasDeadline = options_.timeBudget.count() > 0;
+        const auto deadline = start + options_.timeBudget;
+
+        std::atomic<uint64_t> nextChunk(0);
+        std::atomic<uint64_t> totalHashes(0);
+        std::atomic<bool> stop(false);
+        std::atomic<bool> interrupted(false);
+        std::mutex resultMutex;
+        MiningResult result;
+
+        auto shouldStop = [&]() {
+            if (stop.load(std::memory_order_relaxed)) {
+                return true;
+            }
+            if (cancelled_.load(std::memory_order_relaxed) ||
+                (options_.cancelFlag != nullptr && options_.cancelFlag->load(std::memory_order_relaxed)) ||
+                (hasDeadline && std::chrono::steady_clock::now() >= deadline)) {
+                interrupted.store(true, std::memory_order_relaxed);
+                stop.store(true, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        };
+
+        // Every worker patches its own copy of the header; only the timestamp and nonce ever change
+        const SPHINXBlock::HeaderBytes baseHeader = block.serializeHeader();
+
+        auto worker = [&]() {
+            SPHINXBlock::HeaderBytes header = baseHeader;
+            std::optional<SPHINXBlock::HeaderHasher> hasher;
+            std::string blockHashes[MINING_BATCH];
+            uint64_t hashes = 0;
+            uint64_t sinceLastPoll = 0;
+            uint64_t currentEpoch = UINT64_MAX;
+
+            while (!shouldStop()) {
+                const uint64_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                if (chunk >= totalChunks) {
+                    break; // Nonce and timestamp space exhausted
+                }
+
+                const uint64_t epoch = chunk / chunksPerEpoch;
+                if (epoch != currentEpoch) {
+                    // Rolling the timestamp changes the prefix, so the midstate is absorbed again
+                    SPHINXBlock::setHeaderTimestamp(header, baseTimestamp + static_cast<std::time_t>(epoch));
+                    hasher.emplace(header);
+                    currentEpoch = epoch;
+                }
+
+                const uint64_t first = (chunk % chunksPerEpoch) * chunkSize;
+                const uint64_t last = std::min(first + chunkSize, NONCE_SPACE);
+
+                for (uint64_t nonce = first; nonce < last && !stop.load(std::memory_order_relaxed); nonce += MINING_BATCH) {
+                    const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(MINING_BATCH, last - nonce));
+                    hasher->hashNonces(static_cast<uint32_t>(nonce), count, blockHashes);
+                    hashes += count;
+                    sinceLastPoll += count;
+
+                    for (std::size_t i = 0; i < count; ++i) {
+                        if (meetsDifficulty(blockHashes[i], difficulty)) {
+                            std::lock_guard<std::mutex> lock(resultMutex);
+                            if (!result.found) {
+                                result.found = true;
+                                result.nonce = static_cast<uint32_t>(nonce + i);
+                                result.timestamp = baseTimestamp + static_cast<std::time_t>(epoch);
+                                result.blockHash = blockHashes[i];
+                            }
+                            stop.store(true, std::memory_order_relaxed);
+                            break;
+                        }
+                    }
+
+                    if (sinceLastPoll >= POLL_INTERVAL) {
+                        sinceLastPoll = 0;
+                        if (shouldStop()) {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            totalHashes.fetch_add(hashes, std::memory_order_relaxed);
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount - 1);
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker(); // The calling thread takes part in the search as well
+        for (std::thread& thread : workers) {
+            thread.join();
+        }
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        cancelled_.store(false, std::memory_order_relaxed); // The request (if any) applied to this search
+        result.cancelled = !result.found && interrupted.load(std::memory_order_relaxed);
+        result.hashesTried = totalHashes.load(std::memory_order_relaxed);
+        result.elapsedSeconds = elapsed.count();
+        result.hashesPerSecond = result.elapsedSeconds > 0.0 ? double(result.hashesTried) / result.elapsedSeconds : 0.0;
+        lastHashRate_.store(result.hashesPerSecond, std::memory_order_relaxed);
+
+        return result;
+    }
+} // namespace SPHINXMiner
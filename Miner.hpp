@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXMINER_HPP
+#define SPHINXMINER_HPP
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+#include "Block.hpp"
+
+
+namespace SPHINXBlock {
+    class UtxoStore; // Forward declaration of the UtxoStore class
+}
+
+namespace SPHINXMiner {
+    // Options controlling how the nonce search is spread over the worker threads
+    struct MiningOptions {
+        unsigned int threadCount = 0;                   // Number of worker threads (0 = std::thread::hardware_concurrency())
+        std::chrono::milliseconds timeBudget{0};        // Maximum wall-clock time spent searching (0 = no limit)
+        const std::atomic<bool>* cancelFlag = nullptr;  // Optional external flag; the search stops as soon as it becomes true
+        uint32_t maxTimestampRolls = 600;               // How many seconds the timestamp may roll forward once the nonce space is exhausted
+        uint32_t chunkSize = 1u << 16;                  // Number of nonces handed to a worker per unit of work
+        SPHINXBlock::UtxoStore* utxoStore = nullptr;    // UTXO set a mined block is connected to (nullptr = none)
+    };
+
+    // Outcome of a nonce search
+    struct MiningResult {
+        bool found = false;             // True if a nonce satisfying the difficulty was found
+        bool cancelled = false;         // True if the search was stopped by cancel(), the cancel flag or the time budget
+        uint32_t nonce = 0;             // The winning nonce
+        std::time_t timestamp = 0;      // The (possibly rolled) timestamp the winning nonce belongs to
+        std::string blockHash;          // The block hash produced by the winning nonce/timestamp pair
+        uint64_t hashesTried = 0;       // Total number of block hashes computed by all workers
+        double elapsedSeconds = 0.0;    // Wall-clock duration of the search
+        double hashesPerSecond = 0.0;   // Aggregate hash rate over the search
+    };
+
+    // Returns true if the hash starts with at least `difficulty` '0' characters
+    bool meetsDifficulty(const std::string& blockHash, uint32_t difficulty);
+
+    // Multi-threaded nonce search engine used by SPHINXBlock::Block::mineBlock
+    class MiningEngine {
+    public:
+        explicit MiningEngine(const MiningOptions& options = MiningOptions());
+
+        // Search the nonce space (rolling the timestamp forward when it runs out) for a hash meeting the difficulty
+        MiningResult mine(const SPHINXBlock::Block& block, uint32_t difficulty);
+
+        // Ask the running search (or, if none is running, the next one) to stop; safe to call from any thread
+        void cancel();
+
+        // Returns the hash rate measured by the last completed search
+        double getLastHashRate() const;
+
+    private:
+        MiningOptions options_;
+        std::atomic<bool> cancelled_;
+        std::atomic<double> lastHashRate_;
+    };
+} // namespace SPHINXMiner
+
+#endif // SPHINXMINER_HPP
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXTHREADPOOL_HPP
+#define SPHINXTHREADPOOL_HPP
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace SPHINXBlock {
+    // Fixed-size pool of worker threads shared by the parallel block operations
+    class ThreadPool {
+    public:
+        // Start the workers (0 = std::thread::hardware_concurrency())
+        explicit ThreadPool(unsigned int threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Queue a task and return a future for its result
+        template <typename Function>
+        auto submit(Function&& function) -> std::future<std::invoke_result_t<Function>> {
+            using Result = std::invoke_result_t<Function>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+            std::future<Result> future = task->get_future();
+            enqueue([task]() { (*task)(); });
+            return future;
+        }
+
+        unsigned int getThreadCount() const;
+
+    private:
+        void enqueue(std::function<void()> task);
+        void workerLoop();
+
+        std::vector<std::thread> workers_;
+        std::deque<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool stopping_;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXTHREADPOOL_HPP
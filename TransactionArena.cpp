@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the TransactionArena class, the storage behind Block::transactions_.
+
+// Instead of one heap-allocated std::string per transaction, a block keeps all transaction bytes in a
+// single buffer and an offsets table with one entry per transaction plus a final end offset. Assembling
+// or decoding a block therefore costs two growing allocations instead of one per transaction, and
+// transactions are handed out as string_views without copying. An empty offsets table is the empty arena,
+// so construction, clear() and the noexcept moves never allocate.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "TransactionArena.hpp"
+
+
+namespace SPHINXBlock {
+    TransactionArena::TransactionArena() = default;
+
+    TransactionArena::TransactionArena(TransactionArena&& other) noexcept
+        : bytes_(std::move(other.bytes_)), offsets_(std::move(other.offsets_)) {
+        other.bytes_.clear();
+        other.offsets_.clear();
+    }
+
+    TransactionArena& TransactionArena::operator=(TransactionArena&& other) noexcept {
+        if (this != &other) {
+            bytes_ = std::move(other.bytes_);
+            offsets_ = std::move(other.offsets_);
+            other.bytes_.clear();
+            other.offsets_.clear();
+        }
+        return *this;
+    }
+
+    void TransactionArena::clear() {
+        bytes_.clear();
+        offsets_.clear();
+    }
+
+    void TransactionArena::reserve(std::size_t transactionCount, std::size_t byteCount) {
+        offsets_.reserve(transactionCount + 1);
+        bytes_.reserve(byteCount);
+    }
+
+    void TransactionArena::append(std::string_view transaction) {
+        if (bytes_.size() + transaction.size() > UINT32_MAX) {
+            throw std::length_error("Block transactions exceed 4 GiB");
+        }
+        if (offsets_.empty()) {
+            offsets_.push_back(0); // First transaction: add its start offset
+        }
+        bytes_.append(transaction.data(), transaction.size());
+        offsets_.push_back(static_cast<uint32_t>(bytes_.size()));
+    }
+
+    void TransactionArena::replace(std::size_t index, std::string_view transaction) {
+        if (index >= size()) {
+            throw std::out_of_range("TransactionArena::replace index out of range");
+        }
+        const uint32_t begin = offsets_[index];
+        const uint32_t end = offsets_[index + 1];
+        if (bytes_.size() - (end - begin) + transaction.size() > UINT32_MAX) {
+            throw std::length_error("Block transactions exceed 4 GiB");
+        }
+
+        bytes_.replace(begin, end - begin, transaction.data(), transaction.size());
+        const int64_t delta = static_cast<int64_t>(transaction.size()) - static_cast<int64_t>(end - begin);
+        if (delta != 0) {
+            for (std::size_t i = index + 1; i < offsets_.size(); ++i) {
+                offsets_[i] = static_cast<uint32_t>(offsets_[i] + delta);
+            }
+        }
+    }
+
+    void TransactionArena::assign(const std::vector<std::string>& transactions) {
+        std::size_t byteCount = 0;
+        for (const std::string& transaction : transactions) {
+            byteCount += transaction.size();
+        }
+
+        clear();
+        reserve(transactions.size(), byteCount);
+        for (const std::string& transaction : transactions) {
+            append(transaction);
+        }
+    }
+
+    std::size_t TransactionArena::size() const {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    bool TransactionArena::empty() const {
+        return size() == 0;
+    }
+
+    std::string_view TransactionArena::operator[](std::size_t index) const {
+        return std::string_view(bytes_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+    }
+
+    std::string_view TransactionArena::at(std::size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("No transaction at index " + std::to_string(index));
+        }
+        return (*this)[index];
+    }
+
+    TransactionArena::const_iterator TransactionArena::begin() const {
+        return const_iterator(this, 0);
+    }
+
+    TransactionArena::const_iterator TransactionArena::end() const {
+        return const_iterator(this, size());
+    }
+
+    std::size_t TransactionArena::getByteSize() const {
+        return bytes_.size();
+    }
+
+    std::vector<std::string> TransactionArena::toVector() const {
+        std::vector<std::string> transactions;
+        transactions.reserve(size());
+        for (std::string_view transaction : *this) {
+            transactions.emplace_back(transaction);
+        }
+        return transactions;
+    }
+} // namespace SPHINXBlock
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXTRANSACTIONARENA_HPP
+#define SPHINXTRANSACTIONARENA_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace SPHINXBlock {
+    // Contiguous storage for the transactions of a block: one byte buffer plus an offsets table
+    class TransactionArena {
+    public:
+        // Iterates over the transactions as string_views into the arena
+        class const_iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::string_view;
+
+            const_iterator() = default;
+            const_iterator(const TransactionArena* arena, std::size_t index) : arena_(arena), index_(index) {}
+
+            std::string_view operator*() const { return (*arena_)[index_]; }
+            std::string_view operator[](difference_type n) const { return (*arena_)[index_ + n]; }
+            const_iterator& operator++() { ++index_; return *this; }
+            const_iterator operator++(int) { const_iterator copy = *this; ++index_; return copy; }
+            const_iterator& operator--() { --index_; return *this; }
+            const_iterator operator--(int) { const_iterator copy = *this; --index_; return copy; }
+            const_iterator& operator+=(difference_type n) { index_ += n; return *this; }
+            const_iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+            const_iterator operator+(difference_type n) const { return const_iterator(arena_, index_ + n); }
+            const_iterator operator-(difference_type n) const { return const_iterator(arena_, index_ - n); }
+            difference_type operator-(const const_iterator& other) const { return difference_type(index_) - difference_type(other.index_); }
+            bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+            bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+            bool operator<(const const_iterator& other) const { return index_ < other.index_; }
+
+        private:
+            const TransactionArena* arena_ = nullptr;
+            std::size_t index_ = 0;
+        };
+
+        TransactionArena();
+        TransactionArena(const TransactionArena& other) = default;
+        TransactionArena& operator=(const TransactionArena& other) = default;
+
+        // Moves leave the source a valid empty arena without allocating
+        TransactionArena(TransactionArena&& other) noexcept;
+        TransactionArena& operator=(TransactionArena&& other) noexcept;
+
+        // Remove all transactions (keeps the allocated capacity)
+        void clear();
+
+        // Reserve room for a number of transactions and total bytes
+        void reserve(std::size_t transactionCount, std::size_t byteCount);
+
+        // Append one transaction's bytes to the arena
+        void append(std::string_view transaction);
+
+        // Overwrite the transaction at the given index, shifting the ones after it (O(bytes after it))
+        void replace(std::size_t index, std::string_view transaction);
+
+        // Replace the contents with the given transactions
+        void assign(const std::vector<std::string>& transactions);
+
+        std::size_t size() const;
+        bool empty() const;
+
+        // Views into the arena; they stay valid until the arena is modified
+        std::string_view operator[](std::size_t index) const;
+        std::string_view at(std::size_t index) const;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        // Total size of the transaction bytes
+        std::size_t getByteSize() const;
+
+        // Copy the transactions out as separate strings
+        std::vector<std::string> toVector() const;
+
+    private:
+        std::string bytes_;               // All transactions back to back
+        std::vector<uint32_t> offsets_;   // offsets_[i] is where transaction i starts; offsets_.back() == bytes_.size(), or empty when there are no transactions
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXTRANSACTIONARENA_HPP
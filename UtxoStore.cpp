@@ -0,0 +1,713 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// This code defines the UtxoStore class, the persistent UTXO set that blocks connect to and disconnect from.
+
+// In memory:
+    // The whole set is resident: unspent outputs live in a flat open-addressing table keyed by outpoint. Lookups
+    // probe a dense array of 64-bit key hashes and only touch the key and value arrays on a hash match; deletions
+    // shift the following entries back so no tombstones build up. Every outpoint changed since the last flush is
+    // recorded in the write-back layer (dirty_). Nothing is paged out; the files below are only the durable copy
+    // of the table, so memory grows with the set.
+
+// On disk:
+    // utxo.dat is a snapshot of the whole set and the tip. utxo.log is a journal of batches: each flush appends
+    // one record with the tip and the current value (or removal) of every dirty outpoint, so a flush costs one
+    // write whatever the number of blocks connected since the previous one. A record is written whenever the tip
+    // moved, even if the blocks changed no outpoints, so the tip the undo data ends at is always persisted.
+    // Opening the store loads the snapshot and replays the journal, cutting off a torn record at its end. Once
+    // the journal outgrows the snapshot, flush() rewrites the snapshot (temporary file + rename) and empties the
+    // journal. Renames and the creation of the journal are followed by a directory fsync (with syncOnFlush).
+    // Record counts and field sizes are 32-bit; larger values throw std::length_error rather than wrapping.
+
+// Connecting and reorgs:
+    // connectBlock asks the TransactionDecoder for each transaction's spends and outputs, checks them against
+    // the set (including outputs created earlier in the same block) and only then applies them. The outputs it
+    // spent and the outpoints it created are kept as undo data, so disconnectBlock restores the previous state
+    // without rereading older blocks. The newest maxUndoBlocks undo records are saved to undo.dat on flush.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "UtxoStore.hpp"
+#include "Block.hpp"
+
+
+namespace SPHINXBlock {
+    namespace {
+        constexpr uint32_t SNAPSHOT_MAGIC = 0x55585053;  // "SPXU" little-endian
+        constexpr uint32_t JOURNAL_MAGIC = 0x4A585053;   // "SPXJ"
+        constexpr uint32_t UNDO_MAGIC = 0x4E585053;      // "SPXN"
+        constexpr std::size_t JOURNAL_RECORD_HEADER_SIZE = 12;
+        constexpr std::size_t MIN_COMPACT_SIZE = std::size_t(1) << 20; // Never compact a journal smaller than this
+
+        uint64_t hashKey(std::string_view key) {
+            uint64_t hash = 14695981039346656037ull;  // FNV-1a
+            for (char c : key) {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 1099511628211ull;
+            }
+            return hash == 0 ? 1 : hash;  // 0 marks an empty slot
+        }
+
+        uint32_t checksum(std::string_view data) {
+            uint32_t hash = 2166136261u;  // FNV-1a
+            for (char c : data) {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        std::runtime_error systemError(const std::string& what, const std::string& path) {
+            return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+        }
+
+        // Little-endian field writer for the snapshot, journal and undo files
+        class Writer {
+        public:
+            explicit Writer(std::string& out) : out_(out) {}
+
+            void writeUint8(uint8_t value) { out_.push_back(static_cast<char>(value)); }
+            void writeUint32(uint32_t value) { writeLittleEndian(value, 4); }
+            void writeUint64(uint64_t value) { writeLittleEndian(value, 8); }
+            void writeCount(std::size_t count) {
+                if (count > UINT32_MAX) {
+                    throw std::length_error("UTXO store record field exceeds 2^32 - 1");
+                }
+                writeUint32(static_cast<uint32_t>(count));
+            }
+            void writeBytes(std::string_view value) {
+                writeCount(value.size());
+                out_.append(value);
+            }
+            void writeUtxo(const SPHINXUtxo::UTXO& utxo) {
+                writeBytes(utxo.transactionId);
+                writeUint32(utxo.outputIndex);
+                writeUint64(utxo.amount);
+            }
+
+        private:
+            void writeLittleEndian(uint64_t value, int size) {
+                for (int i = 0; i < size; ++i) {
+                    out_.push_back(static_cast<char>(value >> (8 * i)));
+                }
+            }
+
+            std::string& out_;
+        };
+
+        // Bounds-checked reader matching Writer
+        class Cursor {
+        public:
+            explicit Cursor(std::string_view data) : data_(data) {}
+
+            uint8_t readUint8() { return static_cast<uint8_t>(take(1)[0]); }
+            uint32_t readUint32() { return static_cast<uint32_t>(readLittleEndian(4)); }
+            uint64_t readUint64() { return readLittleEndian(8); }
+            std::string readBytes() { return std::string(take(readUint32())); }
+            SPHINXUtxo::UTXO readUtxo() {
+                SPHINXUtxo::UTXO utxo;
+                utxo.transactionId = readBytes();
+                utxo.outputIndex = readUint32();
+                utxo.amount = readUint64();
+                return utxo;
+            }
+
+        private:
+            std::string_view take(std::size_t size) {
+                if (size > data_.size()) {
+                    throw std::runtime_error("Truncated UTXO store record");
+                }
+                std::string_view bytes = data_.substr(0, size);
+                data_.remove_prefix(size);
+                return bytes;
+            }
+
+            uint64_t readLittleEndian(int size) {
+                std::string_view bytes = take(static_cast<std::size_t>(size));
+                uint64_t value = 0;
+                for (int i = 0; i < size; ++i) {
+                    value |= uint64_t(static_cast<uint8_t>(bytes[i])) << (8 * i);
+                }
+                return value;
+            }
+
+            std::string_view data_;
+        };
+
+        std::string readFile(const std::string& path) {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw systemError("Failed to open", path);
+            }
+            std::string data;
+            char buffer[1 << 16];
+            ssize_t count;
+            while ((count = ::read(fd, buffer, sizeof(buffer))) > 0) {
+                data.append(buffer, static_cast<std::size_t>(count));
+            }
+            ::close(fd);
+            if (count < 0) {
+                throw systemError("Failed to read", path);
+            }
+            return data;
+        }
+
+        void writeAll(int fd, std::string_view data, const std::string& path) {
+            while (!data.empty()) {
+                const ssize_t written = ::write(fd, data.data(), data.size());
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw systemError("Failed to write", path);
+                }
+                data.remove_prefix(static_cast<std::size_t>(written));
+            }
+        }
+
+        // fsync a directory so entries created or renamed in it survive a crash
+        void syncDirectory(const std::string& directory) {
+            const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+            if (fd < 0) {
+                throw systemError("Failed to open", directory);
+            }
+            const int result = ::fsync(fd);
+            ::close(fd);
+            if (result != 0) {
+                throw systemError("Failed to sync", directory);
+            }
+        }
+
+        // Replace a file with new contents so a crash leaves either the old or the new version
+        void replaceFile(const std::string& path, std::string_view data, bool sync) {
+            const std::string temporary = path + ".tmp";
+            const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw systemError("Failed to create", temporary);
+            }
+            try {
+                writeAll(fd, data, temporary);
+                if (sync && ::fdatasync(fd) != 0) {
+                    throw systemError("Failed to sync", temporary);
+                }
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+            ::close(fd);
+            std::filesystem::rename(temporary, path);
+            if (sync) {
+                syncDirectory(std::filesystem::path(path).parent_path().string());
+            }
+        }
+    }
+
+    // Flat hash table
+
+    std::size_t UtxoStore::Table::findSlot(std::string_view key, uint64_t hash) const {
+        const std::size_t mask = hashes_.size() - 1;
+        std::size_t slot = hash & mask;
+        while (hashes_[slot] != 0 && (hashes_[slot] != hash || keys_[slot] != key)) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    const SPHINXUtxo::UTXO* UtxoStore::Table::find(std::string_view key) const {
+        if (size_ == 0) {
+            return nullptr;
+        }
+        const std::size_t slot = findSlot(key, hashKey(key));
+        return hashes_[slot] != 0 ? &values_[slot] : nullptr;
+    }
+
+    void UtxoStore::Table::insert(std::string key, const SPHINXUtxo::UTXO& value) {
+        if ((size_ + 1) * 10 > hashes_.size() * 7) {
+            grow(); // Keep the load factor under 0.7 so probe runs stay short
+        }
+        const uint64_t hash = hashKey(key);
+        const std::size_t slot = findSlot(key, hash);
+        if (hashes_[slot] == 0) {
+            hashes_[slot] = hash;
+            keys_[slot] = std::move(key);
+            ++size_;
+        }
+        values_[slot] = value;
+    }
+
+    bool UtxoStore::Table::erase(std::string_view key) {
+        if (size_ == 0) {
+            return false;
+        }
+        const std::size_t mask = hashes_.size() - 1;
+        std::size_t hole = findSlot(key, hashKey(key));
+        if (hashes_[hole] == 0) {
+            return false;
+        }
+
+        // Backward-shift deletion: move later entries of the probe run into the hole when that keeps them reachable
+        for (std::size_t next = (hole + 1) & mask; hashes_[next] != 0; next = (next + 1) & mask) {
+            const std::size_t home = hashes_[next] & mask;
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                hashes_[hole] = hashes_[next];
+                keys_[hole] = std::move(keys_[next]);
+                values_[hole] = std::move(values_[next]);
+                hole = next;
+            }
+        }
+        hashes_[hole] = 0;
+        keys_[hole].clear();
+        values_[hole] = SPHINXUtxo::UTXO();
+        --size_;
+        return true;
+    }
+
+    void UtxoStore::Table::clear() {
+        hashes_.clear();
+        keys_.clear();
+        values_.clear();
+        size_ = 0;
+    }
+
+    std::size_t UtxoStore::Table::size() const {
+        return size_;
+    }
+
+    void UtxoStore::Table::grow() {
+        std::vector<uint64_t> hashes = std::move(hashes_);
+        std::vector<std::string> keys = std::move(keys_);
+        std::vector<SPHINXUtxo::UTXO> values = std::move(values_);
+
+        const std::size_t capacity = hashes.empty() ? 64 : hashes.size() * 2;
+        hashes_.assign(capacity, 0);
+        keys_.assign(capacity, std::string());
+        values_.assign(capacity, SPHINXUtxo::UTXO());
+
+        for (std::size_t slot = 0; slot < hashes.size(); ++slot) {
+            if (hashes[slot] != 0) {
+                const std::size_t target = findSlot(keys[slot], hashes[slot]);
+                hashes_[target] = hashes[slot];
+                keys_[target] = std::move(keys[slot]);
+                values_[target] = std::move(values[slot]);
+            }
+        }
+    }
+
+    // Store
+
+    UtxoStore::UtxoStore(const std::string& directory, TransactionDecoder decoder, const UtxoStoreOptions& options)
+        : directory_(directory), decoder_(std::move(decoder)), options_(options), undoDirty_(false), tipDirty_(false),
+          tipHeight_(0), journalSize_(0), snapshotSize_(0) {
+        if (!decoder_) {
+            throw std::invalid_argument("UtxoStore needs a transaction decoder");
+        }
+        std::filesystem::create_directories(directory_);
+        load();
+    }
+
+    UtxoStore::~UtxoStore() {
+        try {
+            flush();
+        } catch (...) {
+            // Destructors must not throw; the blocks since the last flush are reconnected on the next start
+        }
+    }
+
+    void UtxoStore::load() {
+        loadSnapshot();
+        replayJournal();
+        loadUndo();
+    }
+
+    void UtxoStore::loadSnapshot() {
+        const std::string path = (std::filesystem::path(directory_) / "utxo.dat").string();
+        if (!std::filesystem::exists(path)) {
+            return;
+        }
+
+        const std::string data = readFile(path);
+        if (data.size() < 4 || checksum(std::string_view(data).substr(0, data.size() - 4)) != Cursor(std::string_view(data).substr(data.size() - 4)).readUint32()) {
+            throw std::runtime_error("Corrupt UTXO snapshot: " + path);
+        }
+
+        Cursor cursor(std::string_view(data).substr(0, data.size() - 4));
+        if (cursor.readUint32() != SNAPSHOT_MAGIC) {
+            throw std::runtime_error("Not a UTXO snapshot: " + path);
+        }
+        tipHeight_ = cursor.readUint32();
+        tipHash_ = cursor.readBytes();
+        const uint64_t count = cursor.readUint64();
+        for (uint64_t i = 0; i < count; ++i) {
+            std::string outpoint = cursor.readBytes();
+            table_.insert(std::move(outpoint), cursor.readUtxo());
+        }
+        snapshotSize_ = data.size();
+    }
+
+    void UtxoStore::replayJournal() {
+        const std::string path = (std::filesystem::path(directory_) / "utxo.log").string();
+        if (!std::filesystem::exists(path)) {
+            return;
+        }
+
+        const std::string data = readFile(path);
+        std::size_t offset = 0;
+        while (data.size() - offset >= JOURNAL_RECORD_HEADER_SIZE) {
+            Cursor header(std::string_view(data).substr(offset, JOURNAL_RECORD_HEADER_SIZE));
+            const uint32_t magic = header.readUint32();
+            const uint32_t payloadSize = header.readUint32();
+            const uint32_t payloadChecksum = header.readUint32();
+            if (magic != JOURNAL_MAGIC || payloadSize > data.size() - offset - JOURNAL_RECORD_HEADER_SIZE) {
+                break;
+            }
+            const std::string_view payload = std::string_view(data).substr(offset + JOURNAL_RECORD_HEADER_SIZE, payloadSize);
+            if (checksum(payload) != payloadChecksum) {
+                break;
+            }
+
+            Cursor cursor(payload);
+            tipHeight_ = cursor.readUint32();
+            tipHash_ = cursor.readBytes();
+            const uint32_t count = cursor.readUint32();
+            for (uint32_t i = 0; i < count; ++i) {
+                const bool present = cursor.readUint8() != 0;
+                std::string outpoint = cursor.readBytes();
+                if (present) {
+                    table_.insert(std::move(outpoint), cursor.readUtxo());
+                } else {
+                    table_.erase(outpoint);
+                }
+            }
+            offset += JOURNAL_RECORD_HEADER_SIZE + payloadSize;
+        }
+
+        if (offset != data.size()) {
+            // Cut off a record torn by a crash during flush
+            std::filesystem::resize_file(path, offset);
+        }
+        journalSize_ = offset;
+    }
+
+    void UtxoStore::loadUndo() {
+        const std::string path = (std::filesystem::path(directory_) / "undo.dat").string();
+        if (!std::filesystem::exists(path)) {
+            return;
+        }
+
+        const std::string data = readFile(path);
+        if (data.size() < 4 || checksum(std::string_view(data).substr(0, data.size() - 4)) != Cursor(std::string_view(data).substr(data.size() - 4)).readUint32()) {
+            return; // Without trustworthy undo data the store still works, it just cannot disconnect older blocks
+        }
+
+        Cursor cursor(std::string_view(data).substr(0, data.size() - 4));
+        if (cursor.readUint32() != UNDO_MAGIC) {
+            return;
+        }
+        const uint32_t count = cursor.readUint32();
+        for (uint32_t i = 0; i < count; ++i) {
+            BlockUndo undo;
+            undo.blockHash = cursor.readBytes();
+            undo.blockHeight = cursor.readUint32();
+            undo.previousTipHash = cursor.readBytes();
+            undo.previousTipHeight = cursor.readUint32();
+            const uint32_t spentCount = cursor.readUint32();
+            for (uint32_t j = 0; j < spentCount; ++j) {
+                std::string outpoint = cursor.readBytes();
+                undo.spent.emplace_back(std::move(outpoint), cursor.readUtxo());
+            }
+            const uint32_t createdCount = cursor.readUint32();
+            for (uint32_t j = 0; j < createdCount; ++j) {
+                undo.created.push_back(cursor.readBytes());
+            }
+            undo_.push_back(std::move(undo));
+        }
+
+        // Undo data is only usable if it ends at the tip the journal restored
+        if (!undo_.empty() && undo_.back().blockHash != tipHash_) {
+            undo_.clear();
+        }
+    }
+
+    void UtxoStore::writeSnapshot() {
+        std::string data;
+        Writer writer(data);
+        writer.writeUint32(SNAPSHOT_MAGIC);
+        writer.writeUint32(tipHeight_);
+        writer.writeBytes(tipHash_);
+        writer.writeUint64(table_.size());
+        table_.forEach([&](const std::string& outpoint, const SPHINXUtxo::UTXO& utxo) {
+            writer.writeBytes(outpoint);
+            writer.writeUtxo(utxo);
+        });
+        writer.writeUint32(checksum(data));
+
+        replaceFile((std::filesystem::path(directory_) / "utxo.dat").string(), data, true);
+        snapshotSize_ = data.size();
+
+        // Everything in the journal is now part of the snapshot
+        std::filesystem::resize_file(std::filesystem::path(directory_) / "utxo.log", 0);
+        journalSize_ = 0;
+    }
+
+    void UtxoStore::writeUndo() {
+        std::string data;
+        Writer writer(data);
+        writer.writeUint32(UNDO_MAGIC);
+        writer.writeCount(undo_.size());
+        for (const BlockUndo& undo : undo_) {
+            writer.writeBytes(undo.blockHash);
+            writer.writeUint32(undo.blockHeight);
+            writer.writeBytes(undo.previousTipHash);
+            writer.writeUint32(undo.previousTipHeight);
+            writer.writeCount(undo.spent.size());
+            for (const auto& [outpoint, utxo] : undo.spent) {
+                writer.writeBytes(outpoint);
+                writer.writeUtxo(utxo);
+            }
+            writer.writeCount(undo.created.size());
+            for (const std::string& outpoint : undo.created) {
+                writer.writeBytes(outpoint);
+            }
+        }
+        writer.writeUint32(checksum(data));
+
+        replaceFile((std::filesystem::path(directory_) / "undo.dat").string(), data, options_.syncOnFlush);
+        undoDirty_ = false;
+    }
+
+    void UtxoStore::flush() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        flushLocked();
+    }
+
+    void UtxoStore::flushLocked() {
+        if (!dirty_.empty() || tipDirty_) {
+            // One journal record holds the whole write-back layer and the tip
+            std::string payload;
+            Writer writer(payload);
+            writer.writeUint32(tipHeight_);
+            writer.writeBytes(tipHash_);
+            writer.writeCount(dirty_.size());
+            for (const std::string& outpoint : dirty_) {
+                const SPHINXUtxo::UTXO* utxo = table_.find(outpoint);
+                writer.writeUint8(utxo != nullptr ? 1 : 0);
+                writer.writeBytes(outpoint);
+                if (utxo != nullptr) {
+                    writer.writeUtxo(*utxo);
+                }
+            }
+
+            std::string record;
+            Writer header(record);
+            header.writeUint32(JOURNAL_MAGIC);
+            header.writeCount(payload.size());
+            header.writeUint32(checksum(payload));
+            record += payload;
+
+            const std::string path = (std::filesystem::path(directory_) / "utxo.log").string();
+            const bool created = !std::filesystem::exists(path);
+            const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            if (fd < 0) {
+                throw systemError("Failed to open UTXO journal", path);
+            }
+            try {
+                writeAll(fd, record, path);
+                if (options_.syncOnFlush && ::fdatasync(fd) != 0) {
+                    throw systemError("Failed to sync UTXO journal", path);
+                }
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+            ::close(fd);
+            if (created && options_.syncOnFlush) {
+                syncDirectory(directory_);
+            }
+
+            journalSize_ += record.size();
+            dirty_.clear();
+            tipDirty_ = false;
+
+            if (journalSize_ > std::max(snapshotSize_, MIN_COMPACT_SIZE)) {
+                writeSnapshot();
+            }
+        }
+
+        if (undoDirty_) {
+            writeUndo();
+        }
+    }
+
+    void UtxoStore::markDirty(const std::string& outpoint) {
+        dirty_.insert(outpoint);
+    }
+
+    void UtxoStore::connectBlock(const Block& block) {
+        // Decode outside the lock; the decoder only looks at the transaction bytes
+        std::vector<UtxoDelta> deltas(block.getTransactionCount());
+        for (std::size_t i = 0; i < deltas.size(); ++i) {
+            decoder_(block.getTransaction(i), deltas[i]);
+        }
+        const std::string blockHash = block.getBlockHash();
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (!tipHash_.empty() && block.getPreviousHash() != tipHash_) {
+            throw std::runtime_error("Block " + blockHash + " does not extend the UTXO tip " + tipHash_);
+        }
+        const uint32_t expectedHeight = tipHash_.empty() ? 0 : tipHeight_ + 1;
+        if (block.getBlockHeight() != expectedHeight) {
+            throw std::runtime_error("Block " + blockHash + " has height " + std::to_string(block.getBlockHeight()) +
+                                     ", expected " + std::to_string(expectedHeight));
+        }
+
+        // Check every spend before touching the table so a bad block leaves the set unchanged
+        BlockUndo undo;
+        undo.blockHash = blockHash;
+        undo.blockHeight = block.getBlockHeight();
+        undo.previousTipHash = tipHash_;
+        undo.previousTipHeight = tipHeight_;
+
+        std::unordered_map<std::string, SPHINXUtxo::UTXO> created;   // Outputs created in this block and still unspent
+        std::unordered_set<std::string> spent;                        // Outputs from the set spent by this block
+        for (UtxoDelta& delta : deltas) {
+            for (std::string& outpoint : delta.spent) {
+                if (created.erase(outpoint) != 0) {
+                    continue; // Created and spent within the block; neither the set nor the undo data sees it
+                }
+                const SPHINXUtxo::UTXO* utxo = table_.find(outpoint);
+                if (utxo == nullptr || !spent.insert(outpoint).second) {
+                    throw std::runtime_error("Block " + blockHash + " spends missing output " + outpoint);
+                }
+                undo.spent.emplace_back(std::move(outpoint), *utxo);
+            }
+            for (auto& [outpoint, utxo] : delta.created) {
+                if ((table_.find(outpoint) != nullptr && spent.count(outpoint) == 0) || created.count(outpoint) != 0) {
+                    throw std::runtime_error("Block " + blockHash + " recreates unspent output " + outpoint);
+                }
+                created.emplace(std::move(outpoint), std::move(utxo));
+            }
+        }
+
+        for (const auto& [outpoint, utxo] : undo.spent) {
+            table_.erase(outpoint);
+            markDirty(outpoint);
+        }
+        undo.created.reserve(created.size());
+        for (auto& [outpoint, utxo] : created) {
+            table_.insert(outpoint, utxo);
+            markDirty(outpoint);
+            undo.created.push_back(outpoint);
+        }
+
+        tipHash_ = blockHash;
+        tipHeight_ = block.getBlockHeight();
+        tipDirty_ = true;
+        undo_.push_back(std::move(undo));
+        while (undo_.size() > options_.maxUndoBlocks) {
+            undo_.pop_front();
+        }
+        undoDirty_ = true;
+
+        if (dirty_.size() >= options_.flushEntries) {
+            flushLocked();
+        }
+    }
+
+    void UtxoStore::disconnectBlock(const Block& block) {
+        const std::string blockHash = block.getBlockHash();
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (blockHash != tipHash_) {
+            throw std::runtime_error("Block " + blockHash + " is not the UTXO tip " + tipHash_);
+        }
+        if (undo_.empty() || undo_.back().blockHash != blockHash) {
+            throw std::runtime_error("No undo data for block " + blockHash);
+        }
+
+        BlockUndo& undo = undo_.back();
+        for (const std::string& outpoint : undo.created) {
+            table_.erase(outpoint);
+            markDirty(outpoint);
+        }
+        for (auto& [outpoint, utxo] : undo.spent) {
+            table_.insert(outpoint, utxo);
+            markDirty(outpoint);
+        }
+
+        tipHash_ = std::move(undo.previousTipHash);
+        tipHeight_ = undo.previousTipHeight;
+        tipDirty_ = true;
+        undo_.pop_back();
+        undoDirty_ = true;
+
+        if (dirty_.size() >= options_.flushEntries) {
+            flushLocked();
+        }
+    }
+
+    std::optional<SPHINXUtxo::UTXO> UtxoStore::find(const std::string& outpoint) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const SPHINXUtxo::UTXO* utxo = table_.find(outpoint);
+        if (utxo == nullptr) {
+            return std::nullopt;
+        }
+        return *utxo;
+    }
+
+    bool UtxoStore::contains(const std::string& outpoint) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return table_.find(outpoint) != nullptr;
+    }
+
+    std::size_t UtxoStore::size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return table_.size();
+    }
+
+    std::string UtxoStore::getTipHash() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return tipHash_;
+    }
+
+    uint32_t UtxoStore::getTipHeight() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return tipHeight_;
+    }
+
+    std::size_t UtxoStore::getDirtyCount() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return dirty_.size();
+    }
+} // namespace SPHINXBlock
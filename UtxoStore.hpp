@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+
+#ifndef SPHINXUTXOSTORE_HPP
+#define SPHINXUTXOSTORE_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Utxo.hpp"
+
+
+namespace SPHINXBlock {
+    class Block; // Forward declaration of the Block class
+
+    // Outputs one transaction spends and creates, keyed by outpoint (the keys of the legacy UTXO map)
+    struct UtxoDelta {
+        std::vector<std::string> spent;
+        std::vector<std::pair<std::string, SPHINXUtxo::UTXO>> created;
+    };
+
+    // Fills in the delta of one transaction; the transaction encoding belongs to the Transaction module
+    using TransactionDecoder = std::function<void(std::string_view transaction, UtxoDelta& delta)>;
+
+    struct UtxoStoreOptions {
+        std::size_t flushEntries = 65536;   // Flush the write-back layer once this many outpoints are dirty
+        std::size_t maxUndoBlocks = 288;    // Undo data kept for reorgs (deepest block that can be disconnected)
+        bool syncOnFlush = true;            // fdatasync the journal on every flush
+    };
+
+    // Long-lived UTXO set: an open-addressing hash table holding the whole set in memory, a write-back layer of
+    // dirty outpoints, and an on-disk snapshot plus journal (the durable copy) that flush() appends to in batches
+    class UtxoStore {
+    public:
+        UtxoStore(const std::string& directory, TransactionDecoder decoder, const UtxoStoreOptions& options = UtxoStoreOptions());
+        ~UtxoStore(); // Flushes the write-back layer
+
+        UtxoStore(const UtxoStore&) = delete;
+        UtxoStore& operator=(const UtxoStore&) = delete;
+
+        // Apply a block on top of the current tip. Throws std::runtime_error (leaving the set unchanged) if the
+        // block does not follow the tip (previousHash, and height tip + 1 or 0 on an empty store) or spends an
+        // outpoint that is not in the set.
+        void connectBlock(const Block& block);
+
+        // Undo the tip block using its undo data. Throws std::runtime_error if the block is not the tip or its
+        // undo data has been pruned.
+        void disconnectBlock(const Block& block);
+
+        std::optional<SPHINXUtxo::UTXO> find(const std::string& outpoint) const;
+        bool contains(const std::string& outpoint) const;
+        std::size_t size() const;
+
+        // Hash and height of the last connected block (empty hash for an empty store)
+        std::string getTipHash() const;
+        uint32_t getTipHeight() const;
+
+        // Append the dirty outpoints and the tip to the journal (compacting it into the snapshot when it grows too large)
+        void flush();
+
+        // Number of outpoints changed since the last flush
+        std::size_t getDirtyCount() const;
+
+    private:
+        // Flat open-addressing table with linear probing; probes only touch the dense hashes_ array
+        class Table {
+        public:
+            const SPHINXUtxo::UTXO* find(std::string_view key) const;
+            void insert(std::string key, const SPHINXUtxo::UTXO& value);  // Inserts or overwrites
+            bool erase(std::string_view key);
+            void clear();
+            std::size_t size() const;
+
+            template <typename Function>
+            void forEach(const Function& function) const {
+                for (std::size_t slot = 0; slot < hashes_.size(); ++slot) {
+                    if (hashes_[slot] != 0) {
+                        function(keys_[slot], values_[slot]);
+                    }
+                }
+            }
+
+        private:
+            std::size_t findSlot(std::string_view key, uint64_t hash) const;
+            void grow();
+
+            std::vector<uint64_t> hashes_;              // 0 marks an empty slot
+            std::vector<std::string> keys_;
+            std::vector<SPHINXUtxo::UTXO> values_;
+            std::size_t size_ = 0;
+        };
+
+        struct BlockUndo {
+            std::string blockHash;
+            uint32_t blockHeight = 0;
+            std::string previousTipHash;
+            uint32_t previousTipHeight = 0;
+            std::vector<std::pair<std::string, SPHINXUtxo::UTXO>> spent;   // Restored on disconnect
+            std::vector<std::string> created;                               // Erased on disconnect
+        };
+
+        void load();
+        void loadSnapshot();
+        void replayJournal();
+        void loadUndo();
+        void writeSnapshot();
+        void writeUndo();
+        void flushLocked();
+        void markDirty(const std::string& outpoint);
+
+        std::string directory_;
+        TransactionDecoder decoder_;
+        UtxoStoreOptions options_;
+
+        Table table_;
+        std::unordered_set<std::string> dirty_;     // Write-back layer: outpoints changed since the last flush
+        std::deque<BlockUndo> undo_;                // Oldest first; the back belongs to the tip
+        bool undoDirty_;
+        bool tipDirty_;                             // The tip moved since the last journal record
+        std::string tipHash_;
+        uint32_t tipHeight_;
+        std::size_t journalSize_;
+        std::size_t snapshotSize_;
+        mutable std::shared_mutex mutex_;
+    };
+} // namespace SPHINXBlock
+
+#endif // SPHINXUTXOSTORE_HPP
@@ -0,0 +1,524 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Google Benchmark suite for the Block hot paths.
+
+// Every benchmark runs over blocks of 1, 10, 100 and MAX_BLOCK_SIZE transactions of TRANSACTION_SIZE bytes.
+// Built against the offline stubs in bench/stubs it needs no other SPHINX module. Run the
+// sphinxblock_bench_json target (or pass --benchmark_out=<file> --benchmark_out_format=json) to get
+// machine-readable results for regression tracking.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Block.hpp"
+#include "BlockCache.hpp"
+#include "BlockCompression.hpp"
+#include "BlockMetrics.hpp"
+#include "BlockPipeline.hpp"
+#include "BlockTemplate.hpp"
+#include "BlockWriter.hpp"
+#include "ChainReindexer.hpp"
+#include "CheckpointIndex.hpp"
+#include "HashBatch.hpp"
+#include "HeaderIndex.hpp"
+#include "HeaderValidator.hpp"
+#include "Miner.hpp"
+#include "Sign.hpp"
+#include "UtxoStore.hpp"
+#include "db.hpp"
+
+
+namespace {
+    constexpr std::size_t TRANSACTION_SIZE = 256;
+    const std::string PREVIOUS_HASH(64, '0');
+    const std::string KEY = "bench_key";
+
+    SPHINXBlock::Block makeBlock(std::size_t transactionCount) {
+        SPHINXBlock::Block block(PREVIOUS_HASH);
+
+        std::vector<std::string> transactions;
+        transactions.reserve(transactionCount);
+        for (std::size_t i = 0; i < transactionCount; ++i) {
+            std::string transaction = "tx" + std::to_string(i) + ":";
+            transaction.resize(TRANSACTION_SIZE, static_cast<char>('a' + i % 26));
+            transactions.push_back(std::move(transaction));
+        }
+        block.setTransactions(std::move(transactions));
+        block.setBlockHeight(static_cast<uint32_t>(transactionCount));
+        block.setMerkleRoot(block.calculateMerkleRoot());
+        block.setSignature(SPHINXSign::sign_data(block.calculateBlockHash(), KEY));
+        return block;
+    }
+
+    void blockSizes(benchmark::internal::Benchmark* benchmark) {
+        benchmark->RangeMultiplier(10)->Range(1, SPHINXBlock::Block::MAX_BLOCK_SIZE);
+    }
+
+    std::string tempPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("sphinxblock_bench_" + name)).string();
+    }
+}
+
+static void BM_CalculateBlockHash(benchmark::State& state) {
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(block.calculateBlockHash());
+    }
+}
+BENCHMARK(BM_CalculateBlockHash)->Apply(blockSizes);
+
+static void BM_GetBlockHash(benchmark::State& state) {
+    // Memoized hash, as seen by indexing and RPC paths that ask for it repeatedly
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(block.getBlockHash());
+    }
+}
+BENCHMARK(BM_GetBlockHash)->Apply(blockSizes);
+
+static void BM_CalculateMerkleRoot(benchmark::State& state) {
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(block.calculateMerkleRoot());
+    }
+}
+BENCHMARK(BM_CalculateMerkleRoot)->Apply(blockSizes);
+
+static void BM_SetTransactions(benchmark::State& state) {
+    // Full Merkle rebuild plus arena copy
+    const std::vector<std::string> transactions = makeBlock(state.range(0)).getTransactions();
+    SPHINXBlock::Block block(PREVIOUS_HASH);
+    for (auto _ : state) {
+        block.setTransactions(transactions);
+        benchmark::DoNotOptimize(block.calculateMerkleRoot());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetTransactions)->Apply(blockSizes);
+
+static void BM_MerkleRebuild(benchmark::State& state) {
+    // Full rebuild of blocks beyond MAX_BLOCK_SIZE, serial (threshold above the leaf count) or parallel
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    const SPHINXBlock::TransactionArena& transactions = block.getTransactionArena();
+    SPHINXBlock::MerkleBuildOptions options;
+    if (state.range(1) == 0) {
+        options.parallelThreshold = SIZE_MAX;
+    }
+    SPHINXBlock::MerkleAccumulator tree;
+    for (auto _ : state) {
+        tree.rebuild(transactions, options);
+        benchmark::DoNotOptimize(tree.getRoot());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MerkleRebuild)
+    ->ArgsProduct({{SPHINXBlock::Block::MAX_BLOCK_SIZE, 16384, 65536}, {0, 1}})
+    ->ArgNames({"transactions", "parallel"})
+    ->UseRealTime();
+
+static void BM_ToJson(benchmark::State& state) {
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(block.toJson().dump());
+    }
+}
+BENCHMARK(BM_ToJson)->Apply(blockSizes);
+
+static void BM_FromJson(benchmark::State& state) {
+    const std::string blockData = makeBlock(state.range(0)).toJson().dump();
+    SPHINXBlock::Block block("");
+    for (auto _ : state) {
+        block.fromJson(nlohmann::json::parse(blockData));
+    }
+    state.SetBytesProcessed(state.iterations() * blockData.size());
+}
+BENCHMARK(BM_FromJson)->Apply(blockSizes);
+
+static void BM_DeserializeJson(benchmark::State& state) {
+    const std::string blockData = makeBlock(state.range(0)).toJson().dump();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SPHINXBlock::Block::deserialize(blockData));
+    }
+    state.SetBytesProcessed(state.iterations() * blockData.size());
+}
+BENCHMARK(BM_DeserializeJson)->Apply(blockSizes);
+
+static void BM_DeserializeJsonHeaderOnly(benchmark::State& state) {
+    const std::string blockData = makeBlock(state.range(0)).toJson().dump();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SPHINXBlock::Block::deserialize(blockData, true));
+    }
+}
+BENCHMARK(BM_DeserializeJsonHeaderOnly)->Apply(blockSizes);
+
+static void BM_ToBinary(benchmark::State& state) {
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(block.toBinary());
+    }
+}
+BENCHMARK(BM_ToBinary)->Apply(blockSizes);
+
+static void BM_FromBinary(benchmark::State& state) {
+    const std::string blockData = makeBlock(state.range(0)).toBinary();
+    SPHINXBlock::Block block("");
+    for (auto _ : state) {
+        block.fromBinary(SPHINXBlock::BlockReader(blockData));
+    }
+    state.SetBytesProcessed(state.iterations() * blockData.size());
+}
+BENCHMARK(BM_FromBinary)->Apply(blockSizes);
+
+static void BM_ReadBlockHeader(benchmark::State& state) {
+    // Header-only decode of a stored block (compare with BM_FromBinary)
+    const std::string blockData = makeBlock(state.range(0)).toBinary();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SPHINXBlock::readBlockHeader(blockData));
+    }
+}
+BENCHMARK(BM_ReadBlockHeader)->Apply(blockSizes);
+
+static void BM_HeaderIndexScan(benchmark::State& state) {
+    // Sequential pass over a contiguous header array, as an index rebuild or difficulty walk would do
+    SPHINXBlock::HeaderIndex index;
+    index.reserve(state.range(0));
+    SPHINXBlock::BlockHeader header = makeBlock(1).getHeader();
+    for (int64_t height = 0; height < state.range(0); ++height) {
+        header.blockHeight = static_cast<uint32_t>(height);
+        index.add(header, SPHINXBlock::Digest{static_cast<uint8_t>(height), static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height >> 16)});
+    }
+    for (auto _ : state) {
+        uint64_t totalDifficulty = 0;
+        for (const SPHINXBlock::BlockHeader& entry : index.getHeaders()) {
+            totalDifficulty += entry.difficulty + entry.nonce;
+        }
+        benchmark::DoNotOptimize(totalDifficulty);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HeaderIndexScan)->Arg(1 << 20);
+
+static void BM_ValidateHeaders(benchmark::State& state) {
+    // Batch header pre-validation (field checks, batched hashing, linkage and proof of work) of a linked chain
+    std::vector<SPHINXBlock::BlockHeader> headers;
+    SPHINXBlock::BlockHeader header = makeBlock(1).getHeader();
+    const SPHINXBlock::HeaderChainTip tip = SPHINXBlock::HeaderChainTip::fromHeader(header);
+    SPHINXBlock::Digest previousHash = tip.blockHash;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        header.previousHash = previousHash;
+        header.blockHeight = tip.blockHeight + static_cast<uint32_t>(i) + 1;
+        header.difficulty = 0;
+        headers.push_back(header);
+        previousHash = SPHINXBlock::decodeDigest(header.calculateHash());
+    }
+
+    SPHINXBlock::HeaderValidationOptions options;
+    options.now = header.timestamp;
+    options.minimumDifficulty = 0; // The headers are not mined; admit them so every pass runs over the whole batch
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SPHINXBlock::validateHeaders(headers, tip, options));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ValidateHeaders)->RangeMultiplier(16)->Range(16, 65536);
+
+static void BM_CheckpointLookup(benchmark::State& state) {
+    // Membership by hash and nearest-checkpoint-below-height queries against an index of range(0) checkpoints
+    std::vector<SPHINXBlock::Checkpoint> checkpoints;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        const uint32_t height = static_cast<uint32_t>(i * 1000);
+        checkpoints.push_back({height, SPHINXBlock::encodeDigest(SPHINXBlock::Digest{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)})});
+    }
+    const SPHINXBlock::CheckpointIndex index(checkpoints);
+
+    uint32_t height = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.contains(checkpoints[height % checkpoints.size()].blockHash));
+        benchmark::DoNotOptimize(index.findAtOrBelow(height * 7919u % static_cast<uint32_t>(state.range(0) * 1000)));
+        ++height;
+    }
+}
+BENCHMARK(BM_CheckpointLookup)->RangeMultiplier(10)->Range(10, 100000);
+
+static void BM_SaveLoad(benchmark::State& state) {
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    const std::string filename = tempPath("block_" + std::to_string(state.range(0)));
+    for (auto _ : state) {
+        block.save(filename);
+        benchmark::DoNotOptimize(SPHINXBlock::Block::load(filename));
+    }
+    std::filesystem::remove(filename);
+}
+BENCHMARK(BM_SaveLoad)->Apply(blockSizes);
+
+#ifndef SPHINXBLOCK_NO_ZSTD
+static void BM_CompressBlock(benchmark::State& state) {
+    // Compress and decompress an encoded block with plain zstd (0) or a dictionary trained on other blocks (1)
+    const std::string blockData = makeBlock(state.range(0)).serialize();
+    std::unique_ptr<SPHINXBlock::BlockCompressor> compressor = std::make_unique<SPHINXBlock::ZstdCompressor>();
+    if (state.range(1) == 1) {
+        std::vector<std::string> samples;
+        for (std::size_t transactions = 1; transactions <= 256; ++transactions) {
+            samples.push_back(makeBlock(transactions).serialize());
+        }
+        compressor = std::make_unique<SPHINXBlock::ZstdDictionaryCompressor>(SPHINXBlock::ZstdDictionaryCompressor::train(samples));
+    }
+
+    std::size_t recordSize = 0;
+    for (auto _ : state) {
+        const std::string record = SPHINXBlock::compressBlock(blockData, *compressor);
+        benchmark::DoNotOptimize(compressor->decompress(std::string_view(record).substr(SPHINXBlock::COMPRESSED_HEADER_SIZE), blockData.size()));
+        recordSize = record.size();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blockData.size()));
+    state.counters["ratio"] = static_cast<double>(blockData.size()) / static_cast<double>(recordSize);
+}
+BENCHMARK(BM_CompressBlock)
+    ->ArgsProduct({{1, 10, 100, 1000}, {0, 1}})
+    ->ArgNames({"transactions", "dictionary"});
+#endif
+
+static void BM_DatabaseRoundTrip(benchmark::State& state) {
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    const std::string blockId = block.getBlockHash();
+    SPHINXDb::DistributedDb distributedDb;
+    for (auto _ : state) {
+        block.saveToDatabase(distributedDb);
+        benchmark::DoNotOptimize(SPHINXBlock::Block::loadFromDatabase(blockId, distributedDb));
+    }
+}
+BENCHMARK(BM_DatabaseRoundTrip)->Apply(blockSizes);
+
+static void BM_BlockWriterImport(benchmark::State& state) {
+    // Write-behind import of a run of blocks; one iteration submits them all and waits for the last batch
+    constexpr int IMPORT_BLOCKS = 64;
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    SPHINXDb::DistributedDb distributedDb;
+    SPHINXBlock::BlockWriter writer(distributedDb);
+    for (auto _ : state) {
+        for (int i = 0; i < IMPORT_BLOCKS; ++i) {
+            writer.submit(block);
+        }
+        writer.flush();
+    }
+    state.SetItemsProcessed(state.iterations() * IMPORT_BLOCKS);
+}
+BENCHMARK(BM_BlockWriterImport)->Apply(blockSizes)->UseRealTime();
+
+static void BM_BlockCacheHit(benchmark::State& state) {
+    // Repeated load of a recent block through the cache (compare with BM_DatabaseRoundTrip)
+    SPHINXDb::DistributedDb distributedDb;
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    block.saveToDatabase(distributedDb);
+    const std::string blockId = block.getBlockHash();
+    SPHINXBlock::BlockCache cache;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cache.loadFromDatabase(blockId, distributedDb));
+    }
+    const SPHINXBlock::BlockCacheStats stats = cache.getStats();
+    state.counters["hit_ratio"] = static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses);
+}
+BENCHMARK(BM_BlockCacheHit)->Apply(blockSizes);
+
+static void BM_MineAttempts(benchmark::State& state) {
+    // Search with an unreachable difficulty for a fixed slice of time and report the attempt rate
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    SPHINXMiner::MiningOptions options;
+    options.threadCount = static_cast<unsigned int>(state.range(1));
+    options.timeBudget = std::chrono::milliseconds(100);
+
+    uint64_t attempts = 0;
+    for (auto _ : state) {
+        SPHINXMiner::MiningEngine engine(options);
+        attempts += engine.mine(block, 65).hashesTried;
+    }
+    state.counters["attempts_per_second"] = benchmark::Counter(static_cast<double>(attempts), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MineAttempts)
+    ->ArgsProduct({{1, 10, 100, SPHINXBlock::Block::MAX_BLOCK_SIZE}, {1, 0}})
+    ->ArgNames({"transactions", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_BlockTemplateReset(benchmark::State& state) {
+    // Full template build from a mempool snapshot of range(0) transactions
+    std::vector<SPHINXBlock::MempoolEntry> mempool;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        mempool.push_back({std::string(TRANSACTION_SIZE, static_cast<char>('a' + i % 26)) + std::to_string(i), static_cast<uint64_t>(i * 7919 % 10007)});
+    }
+    SPHINXBlock::BlockTemplateBuilder builder(PREVIOUS_HASH, 1);
+    for (auto _ : state) {
+        builder.reset(PREVIOUS_HASH, 1, mempool);
+        benchmark::DoNotOptimize(builder.getBlock().getMerkleRoot());
+    }
+}
+BENCHMARK(BM_BlockTemplateReset)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_BlockTemplateAdd(benchmark::State& state) {
+    // Refresh a full template with one newly arrived transaction (compare with BM_BlockTemplateReset)
+    std::vector<SPHINXBlock::MempoolEntry> mempool;
+    for (int64_t i = 0; i < 10000; ++i) {
+        mempool.push_back({std::string(TRANSACTION_SIZE, 'a') + std::to_string(i), static_cast<uint64_t>(i * 7919 % 10007)});
+    }
+    SPHINXBlock::BlockTemplateBuilder builder(PREVIOUS_HASH, 1);
+    builder.reset(PREVIOUS_HASH, 1, mempool);
+
+    uint64_t fee = 10007;
+    for (auto _ : state) {
+        builder.add({std::string(TRANSACTION_SIZE, 'b') + std::to_string(fee), fee++});
+        benchmark::DoNotOptimize(builder.getBlock().getMerkleRoot());
+    }
+}
+BENCHMARK(BM_BlockTemplateAdd);
+
+static void BM_VerifyBlock(benchmark::State& state) {
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(block.verifyBlock(KEY));
+    }
+}
+BENCHMARK(BM_VerifyBlock)->Apply(blockSizes);
+
+static void BM_PipelineSync(benchmark::State& state) {
+    // Decode, check and connect a run of encoded blocks through the staged validation pipeline
+    constexpr int SYNC_BLOCKS = 64;
+    const std::string blockData = makeBlock(state.range(0)).serialize();
+    for (auto _ : state) {
+        SPHINXBlock::BlockPipeline pipeline(KEY, [](const SPHINXBlock::Block&) {});
+        for (int i = 0; i < SYNC_BLOCKS; ++i) {
+            pipeline.submit(blockData);
+        }
+        benchmark::DoNotOptimize(pipeline.finish());
+    }
+    state.SetItemsProcessed(state.iterations() * SYNC_BLOCKS);
+}
+BENCHMARK(BM_PipelineSync)->Apply(blockSizes)->UseRealTime();
+
+static void BM_PipelineSyncCheckpointed(benchmark::State& state) {
+    // The same run with every block on the header chain to the last checkpoint, so signature checks are skipped
+    // (compare with BM_PipelineSync)
+    constexpr int SYNC_BLOCKS = 64;
+    const SPHINXBlock::Block block = makeBlock(state.range(0));
+    const std::string blockData = block.serialize();
+    const SPHINXBlock::CheckpointIndex checkpoints({{block.getBlockHeight(), block.getBlockHash()}});
+    SPHINXBlock::HeaderIndex headers;
+    headers.add(block);
+    SPHINXBlock::BlockPipelineOptions options;
+    options.checkpoints = &checkpoints;
+    options.headerChain = &headers;
+    for (auto _ : state) {
+        SPHINXBlock::BlockPipeline pipeline(KEY, [](const SPHINXBlock::Block&) {}, options);
+        for (int i = 0; i < SYNC_BLOCKS; ++i) {
+            pipeline.submit(blockData);
+        }
+        benchmark::DoNotOptimize(pipeline.finish());
+    }
+    state.SetItemsProcessed(state.iterations() * SYNC_BLOCKS);
+}
+BENCHMARK(BM_PipelineSyncCheckpointed)->Apply(blockSizes)->UseRealTime();
+
+static void BM_ChainReindex(benchmark::State& state) {
+    // Reindex a chain of linked blocks held in memory: prefetch, pipelined checks and in-order connect
+    constexpr std::size_t CHAIN_BLOCKS = 256;
+    class ChainSource : public SPHINXBlock::ReindexSource {
+    public:
+        explicit ChainSource(std::size_t transactionCount) {
+            std::string previousHash = PREVIOUS_HASH;
+            for (std::size_t i = 0; i < CHAIN_BLOCKS; ++i) {
+                SPHINXBlock::Block block = makeBlock(transactionCount);
+                block.setPreviousHash(previousHash);
+                block.setBlockHeight(static_cast<uint32_t>(i));
+                block.setSignature(SPHINXSign::sign_data(block.calculateBlockHash(), KEY));
+                previousHash = block.getBlockHash();
+                blocks_.push_back(std::move(block));
+            }
+        }
+        std::size_t size() const override { return blocks_.size(); }
+        SPHINXBlock::Block load(std::size_t index) const override { return blocks_[index]; }
+        std::size_t getEncodedSize(std::size_t) const override { return 0; }
+
+    private:
+        std::vector<SPHINXBlock::Block> blocks_;
+    };
+
+    const ChainSource source(state.range(0));
+    SPHINXBlock::ReindexOptions options;
+    options.progressInterval = 64;
+    for (auto _ : state) {
+        SPHINXBlock::ChainReindexer reindexer(KEY, options);
+        benchmark::DoNotOptimize(reindexer.run(source, [](const SPHINXBlock::Block&) {}));
+    }
+    state.SetItemsProcessed(state.iterations() * CHAIN_BLOCKS);
+}
+BENCHMARK(BM_ChainReindex)->RangeMultiplier(10)->Range(1, 1000)->UseRealTime();
+
+static void BM_UtxoConnectDisconnect(benchmark::State& state) {
+    // Connect a block whose transactions each create one output, then roll it back with the undo data
+    SPHINXBlock::Block block = makeBlock(state.range(0));
+    block.setBlockHeight(0); // First block of the empty store
+    const std::string directory = tempPath("utxo");
+    std::filesystem::remove_all(directory);
+    {
+        SPHINXBlock::UtxoStore utxoStore(directory, [](std::string_view transaction, SPHINXBlock::UtxoDelta& delta) {
+            delta.created.emplace_back(std::string(transaction.substr(0, 16)), SPHINXUtxo::UTXO{std::string(transaction.substr(0, 16)), 0, 1});
+        });
+        for (auto _ : state) {
+            block.connect(utxoStore);
+            block.disconnect(utxoStore);
+        }
+    }
+    std::filesystem::remove_all(directory);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UtxoConnectDisconnect)->Apply(blockSizes);
+
+static void BM_RecordBlockOp(benchmark::State& state) {
+    // Cost of one timed scope, the overhead SPHINXBLOCK_TIME_OP adds to every instrumented call
+    for (auto _ : state) {
+        SPHINXBLOCK_TIME_OP(CalculateBlockHash);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_RecordBlockOp)->ThreadRange(1, 8);
+
+static void BM_HashBatch(benchmark::State& state) {
+    // SPHINX_256_xN over Merkle-sized pair messages with every eighth one a different length, so the lane
+    // dispatch loop sees both full runs and scalar leftovers. Only the kernels the Hash module registered are
+    // measured; the counters record which one ran (lanes=1 is the scalar path).
+    std::vector<std::string> inputs(state.range(0));
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        inputs[i] = std::string(i % 8 == 7 ? 96 : 128, static_cast<char>('a' + i % 26));
+    }
+    std::vector<std::string> outputs(inputs.size());
+    for (auto _ : state) {
+        SPHINXHash::SPHINX_256_xN(inputs.data(), outputs.data(), inputs.size());
+        benchmark::DoNotOptimize(outputs.data());
+    }
+    state.counters["lanes"] = static_cast<double>(SPHINXHash::getBatchLanes());
+    state.counters["isa"] = static_cast<double>(SPHINXHash::getActiveBatchIsa());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HashBatch)->RangeMultiplier(16)->Range(16, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,22 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+// Offline stand-in for the SPHINX Hash module (see Stubs.cpp).
+
+#pragma once
+
+#include <string>
+
+namespace SPHINXHash {
+    // Returns the 64-character lowercase hex digest of the data
+    std::string SPHINX_256(const std::string& data);
+}
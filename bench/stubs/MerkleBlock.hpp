@@ -0,0 +1,22 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+// Offline stand-in for the SPHINX MerkleBlock module: only the key types are needed.
+
+#pragma once
+
+#include <string>
+
+namespace SPHINXMerkleBlock {
+    using SPHINXPrivKey = std::string;
+    using SPHINXPubKey = std::string;
+}
@@ -0,0 +1,25 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+// Offline stand-in for the SPHINCS+ signer (see Stubs.cpp). The stub treats the private and public key
+// as the same secret, so a block signed with key K verifies with key K.
+
+#pragma once
+
+#include <string>
+
+#include "MerkleBlock.hpp"
+
+namespace SPHINXSign {
+    std::string sign_data(const std::string& data, const SPHINXMerkleBlock::SPHINXPrivKey& privateKey);
+    bool verify_data(const std::string& data, const std::string& signature, const SPHINXMerkleBlock::SPHINXPubKey& publicKey);
+}
@@ -0,0 +1,34 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+// Offline stand-in for the SPHINX UTXO module.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace SPHINXBlock {
+    class Block;
+}
+
+namespace SPHINXUtxo {
+    struct UTXO {
+        std::string transactionId;
+        uint32_t outputIndex = 0;
+        uint64_t amount = 0;
+    };
+
+    // The stub leaves the set untouched
+    void updateUTXOSet(const SPHINXBlock::Block& block, std::map<std::string, UTXO>& utxoSet);
+}
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+// Offline stand-in for the SPHINX distributed database: an in-memory key/value map.
+
+#pragma once
+
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SPHINXDb {
+    class DistributedDb {
+    public:
+        void saveData(const std::string& data, const std::string& key) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            records_[key] = data;
+        }
+
+        // Store several (data, key) records with one call
+        void saveBatch(const std::vector<std::pair<std::string, std::string>>& records) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& [data, key] : records) {
+                records_[key] = data;
+            }
+        }
+
+        std::string loadData(const std::string& key) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = records_.find(key);
+            if (it == records_.end()) {
+                throw std::runtime_error("No record for key: " + key);
+            }
+            return it->second;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::unordered_map<std::string, std::string> records_;
+    };
+}
@@ -0,0 +1,213 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Persistence tests for UtxoStore: the snapshot, journal and undo files it writes must load back to the
+// same set, tip and undo data.
+
+// Transactions:
+    // The test decoder reads "+name" as creating the output "name" and "-name" as spending it, so each block
+    // spells out its delta.
+
+// Cases:
+    // Round trip: connect, flush, reopen; then disconnect after the reopen with the persisted undo data.
+    // Torn journal: cut the last journal record in half; the reopened store is at the previous flush.
+    // Compaction: push the journal past the snapshot so flush() rewrites it; the reopened set is unchanged.
+    // Linkage: a block at the wrong height or on a different parent is rejected and leaves the set unchanged.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Block.hpp"
+#include "UtxoStore.hpp"
+
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what, int line) {
+        if (!condition) {
+            std::fprintf(stderr, "UtxoStoreTest.cpp:%d: check failed: %s\n", line, what);
+            ++failures;
+        }
+    }
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+    template <typename Function>
+    bool throws(const Function& function) {
+        try {
+            function();
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+
+    void decode(std::string_view transaction, SPHINXBlock::UtxoDelta& delta) {
+        const std::string outpoint(transaction.substr(1));
+        if (transaction.front() == '+') {
+            delta.created.emplace_back(outpoint, SPHINXUtxo::UTXO{outpoint, 0, 1});
+        } else {
+            delta.spent.push_back(outpoint);
+        }
+    }
+
+    SPHINXBlock::Block makeBlock(const std::string& previousHash, uint32_t blockHeight, const std::vector<std::string>& transactions) {
+        SPHINXBlock::Block block(previousHash);
+        block.setBlockHeight(blockHeight);
+        for (const std::string& transaction : transactions) {
+            block.addTransaction(transaction);
+        }
+        return block;
+    }
+
+    std::string freshDirectory(const std::string& name) {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / ("sphinxblock_test_" + name);
+        std::filesystem::remove_all(directory);
+        return directory.string();
+    }
+
+    const std::string GENESIS_PARENT(64, '0');
+
+    void testRoundTrip() {
+        const std::string directory = freshDirectory("utxo_round_trip");
+        const SPHINXBlock::Block first = makeBlock(GENESIS_PARENT, 0, {"+a", "+b"});
+        const SPHINXBlock::Block second = makeBlock(first.getBlockHash(), 1, {"-a", "+c"});
+        {
+            SPHINXBlock::UtxoStore store(directory, decode);
+            store.connectBlock(first);
+            store.flush();
+            store.connectBlock(second);
+        } // The destructor flushes the second block
+
+        {
+            SPHINXBlock::UtxoStore store(directory, decode);
+            CHECK(store.getTipHash() == second.getBlockHash());
+            CHECK(store.getTipHeight() == 1);
+            CHECK(store.size() == 2);
+            CHECK(!store.contains("a"));
+            CHECK(store.contains("b") && store.contains("c"));
+            CHECK(store.find("c").has_value() && store.find("c")->amount == 1);
+
+            store.disconnectBlock(second);
+        }
+
+        SPHINXBlock::UtxoStore store(directory, decode);
+        CHECK(store.getTipHash() == first.getBlockHash());
+        CHECK(store.getTipHeight() == 0);
+        CHECK(store.contains("a") && store.contains("b") && !store.contains("c"));
+        std::filesystem::remove_all(directory);
+    }
+
+    void testTornJournal() {
+        const std::string directory = freshDirectory("utxo_torn");
+        const std::filesystem::path journal = std::filesystem::path(directory) / "utxo.log";
+        const SPHINXBlock::Block first = makeBlock(GENESIS_PARENT, 0, {"+a"});
+        const SPHINXBlock::Block second = makeBlock(first.getBlockHash(), 1, {"+b"});
+
+        std::uintmax_t firstRecordEnd = 0;
+        std::uintmax_t secondRecordEnd = 0;
+        {
+            SPHINXBlock::UtxoStore store(directory, decode);
+            store.connectBlock(first);
+            store.flush();
+            firstRecordEnd = std::filesystem::file_size(journal);
+            store.connectBlock(second);
+            store.flush();
+            secondRecordEnd = std::filesystem::file_size(journal);
+        }
+        CHECK(secondRecordEnd > firstRecordEnd);
+        std::filesystem::resize_file(journal, firstRecordEnd + (secondRecordEnd - firstRecordEnd) / 2);
+
+        {
+            SPHINXBlock::UtxoStore store(directory, decode);
+            CHECK(store.getTipHash() == first.getBlockHash());
+            CHECK(store.contains("a") && !store.contains("b"));
+
+            // The torn tail is cut off, so the next record lands on a clean journal
+            store.connectBlock(second);
+        }
+        SPHINXBlock::UtxoStore store(directory, decode);
+        CHECK(store.getTipHash() == second.getBlockHash());
+        CHECK(store.contains("a") && store.contains("b"));
+        std::filesystem::remove_all(directory);
+    }
+
+    void testCompaction() {
+        const std::string directory = freshDirectory("utxo_compaction");
+        const std::filesystem::path snapshot = std::filesystem::path(directory) / "utxo.dat";
+        constexpr int BLOCKS = 64;
+        const std::string padding(20000, 'x'); // Large outpoints push the journal past the compaction threshold
+
+        std::string tipHash = GENESIS_PARENT;
+        {
+            SPHINXBlock::UtxoStore store(directory, decode);
+            for (int i = 0; i < BLOCKS; ++i) {
+                const SPHINXBlock::Block block = makeBlock(tipHash, static_cast<uint32_t>(i), {"+" + std::to_string(i) + padding});
+                store.connectBlock(block);
+                store.flush();
+                tipHash = block.getBlockHash();
+            }
+        }
+        CHECK(std::filesystem::exists(snapshot));
+        CHECK(std::filesystem::file_size(std::filesystem::path(directory) / "utxo.log") < BLOCKS * padding.size()); // Emptied at least once
+
+        SPHINXBlock::UtxoStore store(directory, decode);
+        CHECK(store.getTipHash() == tipHash);
+        CHECK(store.getTipHeight() == BLOCKS - 1);
+        CHECK(store.size() == BLOCKS);
+        for (int i = 0; i < BLOCKS; ++i) {
+            CHECK(store.contains(std::to_string(i) + padding));
+        }
+        std::filesystem::remove_all(directory);
+    }
+
+    void testLinkage() {
+        const std::string directory = freshDirectory("utxo_linkage");
+        SPHINXBlock::UtxoStore store(directory, decode);
+        CHECK(throws([&]() { store.connectBlock(makeBlock(GENESIS_PARENT, 5, {"+a"})); }));
+        CHECK(store.getTipHash().empty() && store.size() == 0);
+
+        const SPHINXBlock::Block first = makeBlock(GENESIS_PARENT, 0, {"+a"});
+        store.connectBlock(first);
+        CHECK(throws([&]() { store.connectBlock(makeBlock(first.getBlockHash(), 2, {"+b"})); }));
+        CHECK(throws([&]() { store.connectBlock(makeBlock(GENESIS_PARENT, 1, {"+b"})); }));
+        CHECK(throws([&]() { store.connectBlock(makeBlock(first.getBlockHash(), 1, {"-missing"})); }));
+        CHECK(store.getTipHash() == first.getBlockHash() && store.size() == 1);
+        std::filesystem::remove_all(directory);
+    }
+}
+
+int main() {
+    try {
+        testRoundTrip();
+        testTornJournal();
+        testCompaction();
+        testLinkage();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "UtxoStoreTest: unexpected exception: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) (2023) SPHINX_ORG
+ *  Authors:
+ *    - (C kusuma) <thekoesoemo@gmail.com>
+ *      GitHub: (https://github.com/chykusuma)
+ *  Contributors:
+ *    - (Contributor 1) <email1@example.com>
+ *      Github: (https://github.com/yourgit)
+ *    - (Contributor 2) <email2@example.com>
+ *      Github: (https://github.com/yourgit)
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// sphinxblock_reindex: replays stored blocks through ChainReindexer (see ChainReindexer.hpp). This build only
+// verifies the blocks and, with --output-store, copies them; it does not rebuild a UTXO set (see "Transactions").
+
+// Usage:
+    // sphinxblock_reindex (--blocks DIR | --store DIR) --public-key FILE [options]
+    //   --blocks DIR          Block files written by Block::save, in file name order
+    //   --store DIR           A BlockStore, by height
+    //   --first-height N      First height read from --store (default 0)
+    //   --public-key FILE     Raw bytes of the key the block signatures verify against
+    //   --output-store DIR    Append the verified blocks to this BlockStore
+    //   --utxo-store DIR      Connect the blocks to this UtxoStore; rejected while no transaction decoder is built in
+    //   --progress FILE       Progress file; an interrupted run resumes from it
+    //   --io-threads N        Threads loading blocks ahead (default 4)
+    //   --verify-threads N    Signature workers (default: all cores)
+    //   --prefetch N          Blocks loaded ahead of the connect stage (default 512)
+    //   --interval N          Blocks between progress saves and reports (default 2000)
+
+// Connect:
+    // Every valid block is appended to --output-store (if given); without it the run only verifies. The
+    // reindexer's flush (run before each progress save) is BlockStore::flush, so --output-store together with
+    // --progress makes a run resumable. With a UtxoStore the blocks are also connected (Block::connect), flush
+    // ends with UtxoStore::flush, and on resume blocks at or below the store's tip are skipped; a block at the tip
+    // height with a different hash stops the run.
+
+// Transactions:
+    // The UtxoStore learns each transaction's spends and outputs from a TransactionDecoder. The transaction
+    // encoding belongs to the Transaction module, which this tool is not linked against, so transactionDecoder()
+    // below has none and --utxo-store is refused rather than building a set with no outputs in it. Return the
+    // Transaction module's decoder there when building against that module.
+
+// Exit status: 0 when every block passes, 1 when a block fails, 2 on usage or I/O errors.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "Block.hpp"
+#include "BlockStore.hpp"
+#include "ChainReindexer.hpp"
+#include "UtxoStore.hpp"
+
+
+namespace {
+    struct Arguments {
+        std::string blocksDirectory;
+        std::string storeDirectory;
+        uint32_t firstHeight = 0;
+        std::string publicKeyFile;
+        std::string utxoStore;
+        std::string outputStore;
+        SPHINXBlock::ReindexOptions options;
+    };
+
+    void printUsage() {
+        std::fprintf(stderr,
+                     "usage: sphinxblock_reindex (--blocks DIR | --store DIR [--first-height N]) --public-key FILE\n"
+                     "                           [--utxo-store DIR] [--output-store DIR] [--progress FILE] [--io-threads N]\n"
+                     "                           [--verify-threads N] [--prefetch N] [--interval N]\n"
+                     "Verifies the blocks and, with --output-store, copies them. No UTXO set is rebuilt: --utxo-store\n"
+                     "is refused because this build has no transaction decoder.\n");
+    }
+
+    std::optional<Arguments> parseArguments(int argc, char** argv) {
+        Arguments arguments;
+        for (int i = 1; i < argc; ++i) {
+            const std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                return std::nullopt;
+            }
+            const std::string value = argv[++i];
+
+            if (flag == "--blocks") {
+                arguments.blocksDirectory = value;
+            } else if (flag == "--store") {
+                arguments.storeDirectory = value;
+            } else if (flag == "--first-height") {
+                arguments.firstHeight = static_cast<uint32_t>(std::stoul(value));
+            } else if (flag == "--public-key") {
+                arguments.publicKeyFile = value;
+            } else if (flag == "--utxo-store") {
+                arguments.utxoStore = value;
+            } else if (flag == "--output-store") {
+                arguments.outputStore = value;
+            } else if (flag == "--progress") {
+                arguments.options.progressFile = value;
+            } else if (flag == "--io-threads") {
+                arguments.options.ioThreads = static_cast<unsigned int>(std::stoul(value));
+            } else if (flag == "--verify-threads") {
+                arguments.options.signatureThreads = static_cast<unsigned int>(std::stoul(value));
+            } else if (flag == "--prefetch") {
+                arguments.options.prefetchBlocks = std::stoul(value);
+            } else if (flag == "--interval") {
+                arguments.options.progressInterval = std::stoul(value);
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        if (arguments.blocksDirectory.empty() == arguments.storeDirectory.empty() || arguments.publicKeyFile.empty()) {
+            return std::nullopt;
+        }
+        return arguments;
+    }
+
+    // Spends and outputs of one transaction, or an empty function when no decoder is built in (see "Transactions")
+    SPHINXBlock::TransactionDecoder transactionDecoder() {
+        return {};
+    }
+
+    void printStats(const char* label, const SPHINXBlock::ReindexStats& stats) {
+        std::fprintf(stderr, "%s: %llu blocks, %.1f MB in %.1f s (%.1f blocks/s, %.2f MB/s), next block %zu\n", label,
+                     static_cast<unsigned long long>(stats.blocks), static_cast<double>(stats.bytes) / (1024.0 * 1024.0),
+                     stats.seconds, stats.getBlocksPerSecond(), stats.getMegabytesPerSecond(), stats.nextIndex);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::optional<Arguments> arguments;
+    try {
+        arguments = parseArguments(argc, argv);
+    } catch (const std::exception&) {
+        // A numeric option did not parse
+    }
+    if (!arguments) {
+        printUsage();
+        return 2;
+    }
+
+    if (!arguments->utxoStore.empty() && !transactionDecoder()) {
+        std::fprintf(stderr, "sphinxblock_reindex: --utxo-store needs a transaction decoder, and this build has none "
+                             "(the Transaction module is not linked in); the tool can only verify and copy blocks\n");
+        return 2;
+    }
+
+    try {
+        std::ifstream keyFile(arguments->publicKeyFile, std::ios::binary);
+        if (!keyFile.is_open()) {
+            throw std::runtime_error("Failed to open public key file: " + arguments->publicKeyFile);
+        }
+        const std::string keyBytes((std::istreambuf_iterator<char>(keyFile)), std::istreambuf_iterator<char>());
+        const SPHINXMerkleBlock::SPHINXPubKey publicKey(keyBytes.begin(), keyBytes.end());
+
+        // Source
+        std::unique_ptr<SPHINXBlock::BlockStore> inputStore;
+        std::unique_ptr<SPHINXBlock::ReindexSource> source;
+        if (!arguments->blocksDirectory.empty()) {
+            source = std::make_unique<SPHINXBlock::BlockFileSource>(arguments->blocksDirectory);
+        } else {
+            inputStore = std::make_unique<SPHINXBlock::BlockStore>(arguments->storeDirectory);
+            source = std::make_unique<SPHINXBlock::BlockStoreSource>(*inputStore, arguments->firstHeight);
+        }
+
+        // Connected state
+        std::unique_ptr<SPHINXBlock::BlockStore> outputStore;
+        std::unique_ptr<SPHINXBlock::UtxoStore> utxoStore;
+        if (!arguments->outputStore.empty()) {
+            SPHINXBlock::BlockStoreOptions storeOptions;
+            storeOptions.fsyncPolicy = SPHINXBlock::FsyncPolicy::Never; // Synced once per progress save instead
+            outputStore = std::make_unique<SPHINXBlock::BlockStore>(arguments->outputStore, storeOptions);
+        }
+        if (!arguments->utxoStore.empty()) {
+            utxoStore = std::make_unique<SPHINXBlock::UtxoStore>(arguments->utxoStore, transactionDecoder());
+        }
+
+        SPHINXBlock::BlockPipeline::ConnectFunction connect = [&](const SPHINXBlock::Block& block) {
+            // Blocks appended after the last progress save are connected again on resume
+            if (outputStore && !outputStore->findByHash(block.getBlockHash())) {
+                outputStore->append(block);
+            }
+            if (!utxoStore) {
+                return;
+            }
+            // The store may have flushed past the last progress save (UtxoStoreOptions::flushEntries)
+            const std::string tipHash = utxoStore->getTipHash();
+            if (!tipHash.empty() && block.getBlockHeight() <= utxoStore->getTipHeight()) {
+                if (block.getBlockHeight() == utxoStore->getTipHeight() && block.getBlockHash() != tipHash) {
+                    throw std::runtime_error("Block " + block.getBlockHash() + " conflicts with the UTXO store tip " + tipHash);
+                }
+                return;
+            }
+            block.connect(*utxoStore);
+        };
+        if (outputStore || utxoStore) {
+            arguments->options.flush = [&outputStore, &utxoStore]() {
+                if (outputStore) {
+                    outputStore->flush();
+                }
+                if (utxoStore) {
+                    utxoStore->flush();
+                }
+            };
+        }
+        arguments->options.onProgress = [](const SPHINXBlock::ReindexStats& stats) { printStats("progress", stats); };
+
+        std::fprintf(stderr, "reindexing %zu blocks\n", source->size());
+        SPHINXBlock::ChainReindexer reindexer(publicKey, arguments->options);
+        const SPHINXBlock::ReindexResult result = reindexer.run(*source, connect);
+        printStats("done", result.stats);
+
+        if (!result.complete) {
+            std::fprintf(stderr, "stopped at block %zu (status %d)%s%s\n", result.failedIndex.value_or(result.stats.nextIndex),
+                         static_cast<int>(result.failedStatus), result.error.empty() ? "" : ": ", result.error.c_str());
+            return 1;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "sphinxblock_reindex: %s\n", e.what());
+        return 2;
+    }
+}